@@ -0,0 +1,176 @@
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "analysis.h"
+#include "board.h"
+#include "output_queue.h"
+#include "search.h"
+
+// one "info" line per line and iteration, then "bestmove" once the last iteration is done:
+// info depth 5 multipv 1 score cp 34 nodes 51234 nps 812000 time 63 pv e2e4 e7e5 g1f3
+// a line that does not fit loses the end of its pv
+#define MAX_INFO_LENGTH (160 + MAX_PLY * 5)
+#define MOVE_TEXT_LENGTH (4)
+
+static double s_start_time;
+static move_t s_best_move;
+
+// all lines of an iteration go out in one push, so a full queue drops the iteration whole
+static char s_report_text[MAX_MOVES * MAX_INFO_LENGTH];
+
+static void report_lines(const search_report_t* report);
+static size_t append_score(char* text, const size_t size, const size_t length, const int score);
+static size_t append_line(char* text, const size_t size, const size_t length, const search_line_t* line);
+static size_t append_move(char* text, const size_t size, const size_t length, const move_t move);
+static size_t append_text(char* text, const size_t size, const size_t length, const char* format, ...);
+static double get_time(void);
+
+// the position comes from the FEN, or is the starting position when there is none
+int analyze(const char* fen_or_null, const size_t max_depth, const size_t line_count)
+{
+    assert(max_depth > 0 && max_depth < MAX_PLY);
+    assert(line_count > 0);
+
+    if (fen_or_null == NULL) {
+        init_board();
+    }
+    else if (!load_fen(fen_or_null)) {
+        fprintf(stderr, "invalid fen: %s\n", fen_or_null);
+        return FALSE;
+    }
+
+    // printing must never hold up the search, a reader that falls behind loses lines instead
+    start_output_queue(stdout);
+
+    s_start_time = get_time();
+    s_best_move = NO_MOVE;
+    search_lines(max_depth, line_count, report_lines);
+
+    // the queued lines are written out first, the result after them goes out directly and is never dropped
+    stop_output_queue();
+
+    if (s_best_move == NO_MOVE) {
+        // checkmate or stalemate, there is nothing to search
+        push_output(is_in_check(get_turn()) ? "info depth 0 score mate 0\n" : "info depth 0 score cp 0\n");
+        push_output("bestmove (none)\n");
+    }
+    else {
+        char text[MAX_INFO_LENGTH];
+        size_t length = append_text(text, sizeof(text), 0, "bestmove ");
+        length = append_move(text, sizeof(text), length, s_best_move);
+        append_text(text, sizeof(text), length, "\n");
+        push_output(text);
+    }
+
+    return TRUE;
+}
+
+static void report_lines(const search_report_t* report)
+{
+    assert(report != NULL);
+
+    double elapsed_time = get_time() - s_start_time;
+    unsigned long long elapsed_ms = (unsigned long long)(elapsed_time * 1000.0);
+    unsigned long long nps = (elapsed_time > 0.0) ? (unsigned long long)((double)report->node_count / elapsed_time) : 0;
+
+    size_t report_length = 0;
+    for (size_t i = 0; i < report->line_count; ++i) {
+        char text[MAX_INFO_LENGTH];
+
+        // one byte is kept for the newline, so a cut off line still ends with one
+        const size_t SIZE = sizeof(text) - 1;
+
+        size_t length = append_text(text, SIZE, 0, "info depth %u multipv %u score ",
+            (unsigned int)report->depth, (unsigned int)i + 1);
+        length = append_score(text, SIZE, length, report->lines[i].score);
+        length = append_text(text, SIZE, length, " nodes %llu nps %llu time %llu pv ",
+            report->node_count, nps, elapsed_ms);
+        length = append_line(text, SIZE, length, &report->lines[i]);
+        length = append_text(text, sizeof(text), length, "\n");
+
+        memcpy(s_report_text + report_length, text, length + 1);
+        report_length += length;
+    }
+
+    if (report_length > 0) {
+        push_output(s_report_text);
+    }
+
+    if (report->line_count > 0) {
+        s_best_move = report->lines[0].moves[0];
+    }
+}
+
+// mates are counted in moves, negative when the side to move gets mated
+static size_t append_score(char* text, const size_t size, const size_t length, const int score)
+{
+    if (score >= MATE_SCORE - MAX_PLY) {
+        return append_text(text, size, length, "mate %d", (MATE_SCORE - score + 1) / 2);
+    }
+    else if (score <= -MATE_SCORE + MAX_PLY) {
+        return append_text(text, size, length, "mate %d", -(MATE_SCORE + score) / 2);
+    }
+
+    return append_text(text, size, length, "cp %d", score);
+}
+
+// moves in coordinate notation separated by spaces, as many whole moves as fit
+static size_t append_line(char* text, const size_t size, const size_t length, const search_line_t* line)
+{
+    assert(line != NULL);
+
+    size_t line_length = length;
+    for (size_t i = 0; i < line->length; ++i) {
+        if (line_length + 1 + MOVE_TEXT_LENGTH >= size) {
+            break;
+        }
+
+        if (i > 0) {
+            line_length = append_text(text, size, line_length, " ");
+        }
+        line_length = append_move(text, size, line_length, line->moves[i]);
+    }
+
+    return line_length;
+}
+
+static size_t append_move(char* text, const size_t size, const size_t length, const move_t move)
+{
+    char src_coord[COORD_LENGTH];
+    char dest_coord[COORD_LENGTH];
+    translate_to_coord(get_move_src(move), src_coord);
+    translate_to_coord(get_move_dest(move), dest_coord);
+
+    return append_text(text, size, length, "%s%s", src_coord, dest_coord);
+}
+
+// returns the new length of the text, whatever does not fit in the size is cut off
+static size_t append_text(char* text, const size_t size, const size_t length, const char* format, ...)
+{
+    assert(text != NULL);
+    assert(format != NULL);
+    assert(length < size);
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(text + length, size - length, format, args);
+    va_end(args);
+
+    if (written < 0) {
+        text[length] = '\0';
+        return length;
+    }
+
+    return (length + (size_t)written < size) ? length + (size_t)written : size - 1;
+}
+
+static double get_time(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include "common_defines.h"
+
+#define DEFAULT_ANALYSIS_DEPTH (6)
+#define DEFAULT_ANALYSIS_LINE_COUNT (3)
+
+int analyze(const char* fen_or_null, const size_t max_depth, const size_t line_count);
+
+#endif // ANALYSIS_H
\ No newline at end of file
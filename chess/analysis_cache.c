@@ -0,0 +1,354 @@
+#define _CRT_SECURE_NO_WARNINGS
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include "analysis_cache.h"
+
+// file layout: a 64-byte header (magic "CCHE", version (u32), bucket count (u32)) followed by the buckets.
+// an entry is two 64-bit words, the packed analysis and a checksum of it together with the full hash.
+// processes share the mapping without locks: an entry torn by two writers, or cut short by a crash,
+// fails its checksum and reads as a miss.
+// the checksum is salted with the evaluator, so entries another evaluator wrote read as misses too
+#define ANALYSIS_CACHE_MAGIC "CCHE"
+// bump when the search changes what a stored score means
+#define ANALYSIS_CACHE_VERSION (2)
+#define ANALYSIS_CACHE_BUCKET_COUNT (1 << 19)
+#define ANALYSIS_CACHE_BUCKET_SIZE (2)
+
+#define DATA_MOVE_SHIFT (0)
+#define DATA_SCORE_SHIFT (16)
+#define DATA_DEPTH_SHIFT (32)
+#define DATA_BOUND_SHIFT (40)
+#define DATA_LEGAL_MOVE_COUNT_SHIFT (42)
+
+#define CHECKSUM_SALT (0x43434845ULL * ANALYSIS_CACHE_VERSION)
+
+typedef struct cache_header {
+    char magic[4];
+    unsigned int version;
+    unsigned int bucket_count;
+    unsigned char reserved[52];
+} cache_header_t;
+
+typedef struct cache_entry {
+    volatile unsigned long long checksum;
+    volatile unsigned long long data;
+} cache_entry_t;
+
+// the first entry keeps the deepest analysis, the second always takes the latest one
+typedef struct cache_bucket {
+    cache_entry_t entries[ANALYSIS_CACHE_BUCKET_SIZE];
+} cache_bucket_t;
+
+static unsigned char* s_mapping = NULL;
+static cache_bucket_t* s_buckets = NULL;
+static unsigned long long s_checksum_salt;
+
+static size_t get_file_size(void);
+static int check_file(const char* file_name, int* out_b_new);
+static int is_valid_header(const cache_header_t* header);
+static void write_header(volatile cache_header_t* header);
+static unsigned char* map_file(const char* file_name, const size_t size);
+static void unmap_file(unsigned char* mapping, const size_t size);
+
+static unsigned long long get_checksum(const hash_t hash, const unsigned long long data);
+static unsigned long long pack_analysis(const cached_analysis_t* analysis);
+static void unpack_analysis(const unsigned long long data, cached_analysis_t* out_analysis);
+static int read_entry(const cache_entry_t* entry, const hash_t hash, cached_analysis_t* out_analysis);
+static void write_entry(cache_entry_t* entry, const hash_t hash, const cached_analysis_t* analysis);
+
+// load the network before opening, the evaluator key has to name the evaluator the search will use
+int open_analysis_cache(const char* file_name, const hash_t evaluator_key)
+{
+    assert(file_name != NULL);
+
+    close_analysis_cache();
+
+    // a file that is not a cache is left as it is, it is neither grown nor written
+    int b_new;
+    if (!check_file(file_name, &b_new)) {
+        fprintf(stderr, "invalid cache file: %s\n", file_name);
+        return FALSE;
+    }
+
+    unsigned char* mapping = map_file(file_name, get_file_size());
+    if (mapping == NULL) {
+        fprintf(stderr, "failed to map cache file: %s\n", file_name);
+        return FALSE;
+    }
+
+    cache_header_t* header = (cache_header_t*)mapping;
+
+    // every process creating the file writes the same header into it
+    if (b_new) {
+        write_header(header);
+    }
+
+    if (!is_valid_header(header)) {
+        fprintf(stderr, "invalid cache file: %s\n", file_name);
+        unmap_file(mapping, get_file_size());
+        return FALSE;
+    }
+
+    s_checksum_salt = (evaluator_key ^ CHECKSUM_SALT) * 0x9e3779b97f4a7c15ULL;
+    s_mapping = mapping;
+    s_buckets = (cache_bucket_t*)(mapping + sizeof(cache_header_t));
+
+    return TRUE;
+}
+
+// entries are written straight into the shared pages, so they outlive the process without a flush
+void close_analysis_cache(void)
+{
+    if (s_mapping == NULL) {
+        return;
+    }
+
+    unmap_file(s_mapping, get_file_size());
+    s_mapping = NULL;
+    s_buckets = NULL;
+}
+
+int probe_analysis_cache(const hash_t hash, cached_analysis_t* out_analysis)
+{
+    assert(out_analysis != NULL);
+
+    if (s_mapping == NULL) {
+        return FALSE;
+    }
+
+    const cache_bucket_t* bucket = &s_buckets[hash & (ANALYSIS_CACHE_BUCKET_COUNT - 1)];
+    for (size_t i = 0; i < ANALYSIS_CACHE_BUCKET_SIZE; ++i) {
+        if (read_entry(&bucket->entries[i], hash, out_analysis)) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+void store_analysis_cache(const hash_t hash, const cached_analysis_t* analysis)
+{
+    assert(analysis != NULL);
+    assert(analysis->depth <= 0xff);
+    assert(analysis->legal_move_count <= UNKNOWN_LEGAL_MOVE_COUNT);
+
+    if (s_mapping == NULL) {
+        return;
+    }
+
+    cache_bucket_t* bucket = &s_buckets[hash & (ANALYSIS_CACHE_BUCKET_COUNT - 1)];
+    cache_entry_t* deep_entry = &bucket->entries[0];
+    cache_entry_t* recent_entry = &bucket->entries[1];
+
+    // what is known about the position from an earlier search is kept when the new one does not know it
+    cached_analysis_t merged = *analysis;
+    cached_analysis_t stored;
+    if (probe_analysis_cache(hash, &stored)) {
+        if (merged.best_move == NO_MOVE) {
+            merged.best_move = stored.best_move;
+        }
+        if (merged.legal_move_count == UNKNOWN_LEGAL_MOVE_COUNT) {
+            merged.legal_move_count = stored.legal_move_count;
+        }
+    }
+
+    // the depth of another position's entry is read without its checksum, a damaged entry only costs a replacement
+    cached_analysis_t deep;
+    unpack_analysis(deep_entry->data, &deep);
+    if (merged.depth >= deep.depth) {
+        write_entry(deep_entry, hash, &merged);
+    }
+    else {
+        write_entry(recent_entry, hash, &merged);
+    }
+}
+
+static size_t get_file_size(void)
+{
+    return sizeof(cache_header_t) + (size_t)ANALYSIS_CACHE_BUCKET_COUNT * sizeof(cache_bucket_t);
+}
+
+// a missing or empty file is new. so is a full-size file with an all-zero header,
+// another process created it and has not written the header yet
+static int check_file(const char* file_name, int* out_b_new)
+{
+    assert(file_name != NULL);
+    assert(out_b_new != NULL);
+
+    *out_b_new = FALSE;
+
+    FILE* fp = fopen(file_name, "rb");
+    if (fp == NULL) {
+        *out_b_new = TRUE;
+        return TRUE;
+    }
+
+    cache_header_t header;
+    size_t read_size = fread(&header, 1, sizeof(header), fp);
+
+    long file_size = -1;
+    if (fseek(fp, 0, SEEK_END) == 0) {
+        file_size = ftell(fp);
+    }
+
+    fclose(fp);
+
+    if (file_size == 0) {
+        *out_b_new = TRUE;
+        return TRUE;
+    }
+
+    if (read_size != sizeof(header)) {
+        return FALSE;
+    }
+
+    const cache_header_t ZERO_HEADER = { { 0, }, 0, 0, { 0, } };
+    if ((size_t)file_size == get_file_size() && memcmp(&header, &ZERO_HEADER, sizeof(header)) == 0) {
+        *out_b_new = TRUE;
+        return TRUE;
+    }
+
+    return is_valid_header(&header);
+}
+
+static int is_valid_header(const cache_header_t* header)
+{
+    assert(header != NULL);
+
+    return memcmp(header->magic, ANALYSIS_CACHE_MAGIC, sizeof(header->magic)) == 0
+        && header->version == ANALYSIS_CACHE_VERSION
+        && header->bucket_count == ANALYSIS_CACHE_BUCKET_COUNT;
+}
+
+// volatile stores keep their order, so the magic goes last and a reader never accepts a half-written header
+static void write_header(volatile cache_header_t* header)
+{
+    assert(header != NULL);
+
+    header->version = ANALYSIS_CACHE_VERSION;
+    header->bucket_count = ANALYSIS_CACHE_BUCKET_COUNT;
+    for (size_t i = 0; i < sizeof(header->magic); ++i) {
+        header->magic[i] = ANALYSIS_CACHE_MAGIC[i];
+    }
+}
+
+// the file is created, or grown, to the full size; the new part reads as zeros
+static unsigned char* map_file(const char* file_name, const size_t size)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(file_name, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+
+    // the mapping object keeps the file open, and the view keeps the mapping object alive
+    HANDLE file_mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE,
+        (DWORD)((unsigned long long)size >> 32), (DWORD)size, NULL);
+    CloseHandle(file);
+    if (file_mapping == NULL) {
+        return NULL;
+    }
+
+    void* mapping = MapViewOfFile(file_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    CloseHandle(file_mapping);
+
+    return (unsigned char*)mapping;
+#else
+    int fd = open(file_name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0
+        || ((size_t)file_stat.st_size < size && ftruncate(fd, (off_t)size) != 0)) {
+        close(fd);
+        return NULL;
+    }
+
+    void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    return (mapping == MAP_FAILED) ? NULL : (unsigned char*)mapping;
+#endif // _WIN32
+}
+
+static void unmap_file(unsigned char* mapping, const size_t size)
+{
+    assert(mapping != NULL);
+
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(mapping);
+#else
+    munmap(mapping, size);
+#endif // _WIN32
+}
+
+// an all-zero entry, or an entry of another position, does not pass
+static unsigned long long get_checksum(const hash_t hash, const unsigned long long data)
+{
+    unsigned long long z = hash ^ (data * 0x9e3779b97f4a7c15ULL) ^ s_checksum_salt;
+    z = (z ^ (z >> 33)) * 0xff51afd7ed558ccdULL;
+    z = (z ^ (z >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+
+    return z ^ (z >> 33);
+}
+
+static unsigned long long pack_analysis(const cached_analysis_t* analysis)
+{
+    assert(analysis != NULL);
+    assert(analysis->score >= -0x8000 && analysis->score < 0x8000);
+
+    return ((unsigned long long)analysis->best_move << DATA_MOVE_SHIFT)
+        | ((unsigned long long)(unsigned short)analysis->score << DATA_SCORE_SHIFT)
+        | ((unsigned long long)analysis->depth << DATA_DEPTH_SHIFT)
+        | ((unsigned long long)analysis->bound << DATA_BOUND_SHIFT)
+        | ((unsigned long long)analysis->legal_move_count << DATA_LEGAL_MOVE_COUNT_SHIFT);
+}
+
+static void unpack_analysis(const unsigned long long data, cached_analysis_t* out_analysis)
+{
+    assert(out_analysis != NULL);
+
+    out_analysis->best_move = (move_t)(data >> DATA_MOVE_SHIFT);
+    out_analysis->score = (short)(unsigned short)(data >> DATA_SCORE_SHIFT);
+    out_analysis->depth = (size_t)((data >> DATA_DEPTH_SHIFT) & 0xff);
+    out_analysis->bound = (cache_bound_t)((data >> DATA_BOUND_SHIFT) & 0x3);
+    out_analysis->legal_move_count = (size_t)((data >> DATA_LEGAL_MOVE_COUNT_SHIFT) & 0xff);
+}
+
+static int read_entry(const cache_entry_t* entry, const hash_t hash, cached_analysis_t* out_analysis)
+{
+    unsigned long long data = entry->data;
+    unsigned long long checksum = entry->checksum;
+
+    if (checksum != get_checksum(hash, data)) {
+        return FALSE;
+    }
+
+    unpack_analysis(data, out_analysis);
+    return TRUE;
+}
+
+static void write_entry(cache_entry_t* entry, const hash_t hash, const cached_analysis_t* analysis)
+{
+    unsigned long long data = pack_analysis(analysis);
+
+    entry->data = data;
+    entry->checksum = get_checksum(hash, data);
+}
\ No newline at end of file
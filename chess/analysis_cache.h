@@ -0,0 +1,33 @@
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+#include "common_defines.h"
+#include "move.h"
+#include "zobrist.h"
+
+#define ANALYSIS_CACHE_FILE_NAME "chess.cache"
+
+#define UNKNOWN_LEGAL_MOVE_COUNT (0xff)
+
+typedef enum cache_bound {
+	CACHE_BOUND_NONE,
+	CACHE_BOUND_UPPER,
+	CACHE_BOUND_LOWER,
+	CACHE_BOUND_EXACT
+} cache_bound_t;
+
+typedef struct cached_analysis {
+	move_t best_move;
+	int score;
+	size_t depth;
+	cache_bound_t bound;
+	size_t legal_move_count;
+} cached_analysis_t;
+
+int open_analysis_cache(const char* file_name, const hash_t evaluator_key);
+void close_analysis_cache(void);
+
+int probe_analysis_cache(const hash_t hash, cached_analysis_t* out_analysis);
+void store_analysis_cache(const hash_t hash, const cached_analysis_t* analysis);
+
+#endif // ANALYSIS_CACHE_H
\ No newline at end of file
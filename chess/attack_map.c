@@ -0,0 +1,157 @@
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "attack_map.h"
+
+static void update_piece_attacks(attack_map_t* attack_map, const piece_t board[],
+    const square_t square, const int delta);
+static void update_attacks(attack_map_t* attack_map, const piece_t board[], const size_t color_index,
+    const square_t square, const int offsets[][2], const size_t offset_count, const int b_slide, const int delta);
+static void update_rays_through(attack_map_t* attack_map, const piece_t board[],
+    const square_t square, const int offsets[][2], const shape_t slider_shape, const int delta);
+
+void init_attack_map(attack_map_t* attack_map, const piece_t board[], const piece_list_t* piece_list)
+{
+    assert(attack_map != NULL);
+    assert(board != NULL);
+    assert(piece_list != NULL);
+
+    memset(attack_map->counts, 0, sizeof(attack_map->counts));
+
+    for (size_t color_index = 0; color_index < COLOR_COUNT; ++color_index) {
+        for (size_t i = 0; i < piece_list->counts[color_index]; ++i) {
+            add_piece_attacks(attack_map, board, piece_list->squares[color_index][i]);
+        }
+    }
+}
+
+void add_piece_attacks(attack_map_t* attack_map, const piece_t board[], const square_t square)
+{
+    update_piece_attacks(attack_map, board, square, 1);
+}
+
+void remove_piece_attacks(attack_map_t* attack_map, const piece_t board[], const square_t square)
+{
+    update_piece_attacks(attack_map, board, square, -1);
+}
+
+// a piece leaving the square extends the rays of the sliders that were stopped on it,
+// call after the square is emptied
+void add_rays_through(attack_map_t* attack_map, const piece_t board[], const square_t square)
+{
+    assert(board[square] == 0);
+
+    update_rays_through(attack_map, board, square, g_bishop_offsets, SHAPE_BISHOP, 1);
+    update_rays_through(attack_map, board, square, g_rook_offsets, SHAPE_ROOK, 1);
+}
+
+// a piece arriving on the square cuts the rays of the sliders passing over it,
+// call while the square is still empty
+void remove_rays_through(attack_map_t* attack_map, const piece_t board[], const square_t square)
+{
+    assert(board[square] == 0);
+
+    update_rays_through(attack_map, board, square, g_bishop_offsets, SHAPE_BISHOP, -1);
+    update_rays_through(attack_map, board, square, g_rook_offsets, SHAPE_ROOK, -1);
+}
+
+int is_attacked(const attack_map_t* attack_map, const square_t square, const color_t attacker_color)
+{
+    assert(attack_map != NULL);
+    assert(square < SQUARE_COUNT);
+
+    return attack_map->counts[get_color_index(attacker_color)][square] != 0;
+}
+
+static void update_piece_attacks(attack_map_t* attack_map, const piece_t board[],
+    const square_t square, const int delta)
+{
+    assert(attack_map != NULL);
+    assert(board != NULL);
+    assert(square < SQUARE_COUNT);
+
+    piece_t piece = board[square];
+    shape_t shape = get_shape(piece);
+    size_t color_index = get_color_index(get_color(piece));
+
+    switch (shape) {
+    case SHAPE_KING:
+        update_attacks(attack_map, board, color_index, square, g_king_offsets, KING_OFFSET_COUNT, FALSE, delta);
+        break;
+    case SHAPE_QUEEN:
+    case SHAPE_ROOK:
+    case SHAPE_BISHOP:
+        if ((shape & SHAPE_ROOK) == SHAPE_ROOK) {
+            update_attacks(attack_map, board, color_index, square, g_rook_offsets, ROOK_OFFSET_COUNT, TRUE, delta);
+        }
+        if ((shape & SHAPE_BISHOP) == SHAPE_BISHOP) {
+            update_attacks(attack_map, board, color_index, square, g_bishop_offsets, BISHOP_OFFSET_COUNT, TRUE, delta);
+        }
+        break;
+    case SHAPE_KNIGHT:
+        update_attacks(attack_map, board, color_index, square, g_knight_offsets, KNIGHT_OFFSET_COUNT, FALSE, delta);
+        break;
+    case SHAPE_PAWN:
+    {
+        const int direction = (get_color(piece) == COLOR_WHITE) ? -1 : 1;
+        const int pawn_offsets[2][2] = { { -1, direction }, { 1, direction } };
+        update_attacks(attack_map, board, color_index, square, pawn_offsets, 2, FALSE, delta);
+        break;
+    }
+    default:
+        assert(FALSE && "invalid shape");
+        break;
+    }
+}
+
+// the square a ray stops on is attacked whatever stands there
+static void update_attacks(attack_map_t* attack_map, const piece_t board[], const size_t color_index,
+    const square_t square, const int offsets[][2], const size_t offset_count, const int b_slide, const int delta)
+{
+    size_t x = get_square_x(square);
+    size_t y = get_square_y(square);
+
+    for (size_t i = 0; i < offset_count; ++i) {
+        square_t ray[MAX_RAY_LENGTH];
+        size_t ray_length = get_ray_squares(board, x, y, offsets[i], b_slide, ray);
+
+        for (size_t j = 0; j < ray_length; ++j) {
+            attack_map->counts[color_index][ray[j]] += (unsigned char)delta;
+        }
+    }
+}
+
+// for every slider looking at the square, walk its ray on past the square up to the next blocker
+static void update_rays_through(attack_map_t* attack_map, const piece_t board[],
+    const square_t square, const int offsets[][2], const shape_t slider_shape, const int delta)
+{
+    assert(attack_map != NULL);
+    assert(board != NULL);
+    assert(square < SQUARE_COUNT);
+
+    size_t x = get_square_x(square);
+    size_t y = get_square_y(square);
+
+    for (size_t i = 0; i < 4; ++i) {
+        const int reverse_offset[2] = { -offsets[i][0], -offsets[i][1] };
+
+        square_t ray[MAX_RAY_LENGTH];
+        size_t ray_length = get_ray_squares(board, x, y, offsets[i], TRUE, ray);
+        if (ray_length == 0) {
+            continue;
+        }
+
+        piece_t slider = board[ray[ray_length - 1]];
+        if ((get_shape(slider) & slider_shape) != slider_shape) {
+            continue;
+        }
+
+        size_t color_index = get_color_index(get_color(slider));
+
+        ray_length = get_ray_squares(board, x, y, reverse_offset, TRUE, ray);
+        for (size_t j = 0; j < ray_length; ++j) {
+            attack_map->counts[color_index][ray[j]] += (unsigned char)delta;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef ATTACK_MAP_H
+#define ATTACK_MAP_H
+
+#include "common_defines.h"
+#include "piece.h"
+#include "piece_list.h"
+
+// number of pieces of each color attacking a square
+typedef struct attack_map {
+	unsigned char counts[COLOR_COUNT][SQUARE_COUNT];
+} attack_map_t;
+
+void init_attack_map(attack_map_t* attack_map, const piece_t board[], const piece_list_t* piece_list);
+void add_piece_attacks(attack_map_t* attack_map, const piece_t board[], const square_t square);
+void remove_piece_attacks(attack_map_t* attack_map, const piece_t board[], const square_t square);
+void add_rays_through(attack_map_t* attack_map, const piece_t board[], const square_t square);
+void remove_rays_through(attack_map_t* attack_map, const piece_t board[], const square_t square);
+
+int is_attacked(const attack_map_t* attack_map, const square_t square, const color_t attacker_color);
+
+#endif // ATTACK_MAP_H
\ No newline at end of file
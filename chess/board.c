@@ -1,15 +1,31 @@
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
+#include "attack_map.h"
 #include "board.h"
+#include "evaluation.h"
 #include "input.h"
+#include "nnue.h"
 #include "piece.h"
+#include "piece_list.h"
 #include "validations.h"
+#include "zobrist.h"
 
-static piece_t s_board[BOARD_HEIGHT][BOARD_WIDTH];
+static piece_t s_board[SQUARE_COUNT];
 static color_t s_cur_turn;
-
-static void move(piece_t board[][BOARD_WIDTH], const size_t src_x, const size_t src_y, const size_t dest_x, const size_t dest_y);
+static piece_list_t s_piece_list;
+static attack_map_t s_attack_map;
+static evaluation_t s_evaluation;
+static nnue_accumulator_t s_nnue_accumulator;
+static hash_t s_hash;
+
+static void move(const square_t src, const square_t dest);
+static void put_piece(const square_t square, const piece_t piece);
+static void remove_piece(const square_t square);
+static void switch_turn(void);
+static void init_board_state(void);
+static piece_t get_fen_piece(const char symbol);
 
 void init_board(void)
 {
@@ -38,76 +54,172 @@ void init_board(void)
     const size_t RIGHT_KNIGHT_X = 6;
 
     // king
-    s_board[WHITE_KING_Y][KING_X] = SHAPE_KING | COLOR_WHITE;
-    s_board[BLACK_KING_Y][KING_X] = SHAPE_KING | COLOR_BLACK;
+    s_board[to_square(KING_X, WHITE_KING_Y)] = SHAPE_KING | COLOR_WHITE;
+    s_board[to_square(KING_X, BLACK_KING_Y)] = SHAPE_KING | COLOR_BLACK;
 
     // queen
-    s_board[WHITE_MAJOR_Y][QUEEN_X] = SHAPE_QUEEN | COLOR_WHITE;
-    s_board[BLACK_MAJOR_Y][QUEEN_X] = SHAPE_QUEEN | COLOR_BLACK;
+    s_board[to_square(QUEEN_X, WHITE_MAJOR_Y)] = SHAPE_QUEEN | COLOR_WHITE;
+    s_board[to_square(QUEEN_X, BLACK_MAJOR_Y)] = SHAPE_QUEEN | COLOR_BLACK;
 
     // rook
-    s_board[WHITE_MAJOR_Y][LEFT_ROOK_X] = SHAPE_ROOK | COLOR_WHITE;
-    s_board[WHITE_MAJOR_Y][RIGHT_ROOK_X] = SHAPE_ROOK | COLOR_WHITE;
-    s_board[BLACK_MAJOR_Y][LEFT_ROOK_X] = SHAPE_ROOK | COLOR_BLACK;
-    s_board[BLACK_MAJOR_Y][RIGHT_ROOK_X] = SHAPE_ROOK | COLOR_BLACK;
+    s_board[to_square(LEFT_ROOK_X, WHITE_MAJOR_Y)] = SHAPE_ROOK | COLOR_WHITE;
+    s_board[to_square(RIGHT_ROOK_X, WHITE_MAJOR_Y)] = SHAPE_ROOK | COLOR_WHITE;
+    s_board[to_square(LEFT_ROOK_X, BLACK_MAJOR_Y)] = SHAPE_ROOK | COLOR_BLACK;
+    s_board[to_square(RIGHT_ROOK_X, BLACK_MAJOR_Y)] = SHAPE_ROOK | COLOR_BLACK;
 
     // bishop
-    s_board[WHITE_MINOR_Y][LEFT_BISHOP_X] = SHAPE_BISHOP | COLOR_WHITE;
-    s_board[WHITE_MINOR_Y][RIGHT_BISHOP_X] = SHAPE_BISHOP | COLOR_WHITE;
-    s_board[BLACK_MINOR_Y][LEFT_BISHOP_X] = SHAPE_BISHOP | COLOR_BLACK;
-    s_board[BLACK_MINOR_Y][RIGHT_BISHOP_X] = SHAPE_BISHOP | COLOR_BLACK;
+    s_board[to_square(LEFT_BISHOP_X, WHITE_MINOR_Y)] = SHAPE_BISHOP | COLOR_WHITE;
+    s_board[to_square(RIGHT_BISHOP_X, WHITE_MINOR_Y)] = SHAPE_BISHOP | COLOR_WHITE;
+    s_board[to_square(LEFT_BISHOP_X, BLACK_MINOR_Y)] = SHAPE_BISHOP | COLOR_BLACK;
+    s_board[to_square(RIGHT_BISHOP_X, BLACK_MINOR_Y)] = SHAPE_BISHOP | COLOR_BLACK;
 
     // knight
-    s_board[WHITE_MINOR_Y][LEFT_KNIGHT_X] = SHAPE_KNIGHT | COLOR_WHITE;
-    s_board[WHITE_MINOR_Y][RIGHT_KNIGHT_X] = SHAPE_KNIGHT | COLOR_WHITE;
-    s_board[BLACK_MINOR_Y][LEFT_KNIGHT_X] = SHAPE_KNIGHT | COLOR_BLACK;
-    s_board[BLACK_MINOR_Y][RIGHT_KNIGHT_X] = SHAPE_KNIGHT | COLOR_BLACK;
+    s_board[to_square(LEFT_KNIGHT_X, WHITE_MINOR_Y)] = SHAPE_KNIGHT | COLOR_WHITE;
+    s_board[to_square(RIGHT_KNIGHT_X, WHITE_MINOR_Y)] = SHAPE_KNIGHT | COLOR_WHITE;
+    s_board[to_square(LEFT_KNIGHT_X, BLACK_MINOR_Y)] = SHAPE_KNIGHT | COLOR_BLACK;
+    s_board[to_square(RIGHT_KNIGHT_X, BLACK_MINOR_Y)] = SHAPE_KNIGHT | COLOR_BLACK;
 
     // pawn
     for (size_t i = 0; i < BOARD_WIDTH; ++i) {
-        s_board[WHITE_PAWN_Y][i] = SHAPE_PAWN | COLOR_WHITE;
-        s_board[BLACK_PAWN_Y][i] = SHAPE_PAWN | COLOR_BLACK;
+        s_board[to_square(i, WHITE_PAWN_Y)] = SHAPE_PAWN | COLOR_WHITE;
+        s_board[to_square(i, BLACK_PAWN_Y)] = SHAPE_PAWN | COLOR_BLACK;
     }
 
     s_cur_turn = COLOR_WHITE;
+
+    init_board_state();
 }
 
-void update_board(void)
+// only the placement and the side to move are read, the rules have no castling or en passant
+int load_fen(const char* fen)
 {
-    assert(is_valid_coord(g_src_coord));
-    assert(is_valid_coord(g_dest_coord));
+    assert(fen != NULL);
+
+    piece_t board[SQUARE_COUNT];
+    memset(board, 0, sizeof(board));
+
+    size_t x = 0;
+    size_t y = 0;
+    size_t piece_counts[COLOR_COUNT] = { 0, };
+    size_t king_counts[COLOR_COUNT] = { 0, };
+
+    const char* p = fen;
+    for (; *p != '\0' && *p != ' '; ++p) {
+        if (*p == '/') {
+            if (x != BOARD_WIDTH) {
+                return FALSE;
+            }
+            x = 0;
+            ++y;
+            continue;
+        }
+
+        if (*p >= '1' && *p <= '8') {
+            x += *p - '0';
+            if (x > BOARD_WIDTH) {
+                return FALSE;
+            }
+            continue;
+        }
+
+        piece_t piece = get_fen_piece(*p);
+        if (piece == 0 || !is_valid_xy(x, y)) {
+            return FALSE;
+        }
+
+        // a pawn never stands on the first or last rank
+        if (get_shape(piece) == SHAPE_PAWN && (y == 0 || y == BOARD_HEIGHT - 1)) {
+            return FALSE;
+        }
+
+        // a pawn off its starting rank has moved and may not advance two squares
+        const size_t PAWN_Y = (get_color(piece) == COLOR_WHITE) ? BOARD_HEIGHT - 2 : 1;
+        if (get_shape(piece) == SHAPE_PAWN && y != PAWN_Y) {
+            piece |= MOVE_FLAG;
+        }
+
+        size_t color_index = get_color_index(get_color(piece));
+        ++piece_counts[color_index];
+        if (get_shape(piece) == SHAPE_KING) {
+            ++king_counts[color_index];
+        }
+
+        board[to_square(x, y)] = piece;
+        ++x;
+    }
+
+    if (x != BOARD_WIDTH || y != BOARD_HEIGHT - 1) {
+        return FALSE;
+    }
+
+    for (size_t i = 0; i < COLOR_COUNT; ++i) {
+        if (king_counts[i] != 1 || piece_counts[i] > MAX_PIECE_COUNT) {
+            return FALSE;
+        }
+    }
+
+    color_t turn = COLOR_WHITE;
+    if (*p == ' ') {
+        ++p;
+        if (*p == 'b') {
+            turn = COLOR_BLACK;
+        }
+        else if (*p != 'w') {
+            return FALSE;
+        }
+    }
+
+    piece_t prev_board[SQUARE_COUNT];
+    memcpy(prev_board, s_board, sizeof(s_board));
+    color_t prev_turn = s_cur_turn;
 
-    size_t src_x = translate_to_board_x(g_src_coord);
-    size_t src_y = translate_to_board_y(g_src_coord);
-    size_t dest_x = translate_to_board_x(g_dest_coord);
-    size_t dest_y = translate_to_board_y(g_dest_coord);
+    memcpy(s_board, board, sizeof(s_board));
+    s_cur_turn = turn;
 
-    piece_t selected_piece = s_board[src_y][src_x];
+    init_board_state();
+
+    // the side that just moved cannot have left its king in check, the search would capture it
+    color_t waiting_color = (turn == COLOR_WHITE) ? COLOR_BLACK : COLOR_WHITE;
+    if (is_in_check(waiting_color)) {
+        memcpy(s_board, prev_board, sizeof(s_board));
+        s_cur_turn = prev_turn;
+
+        init_board_state();
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void update_board(void)
+{
+    assert(g_src_square < SQUARE_COUNT);
+    assert(g_dest_square < SQUARE_COUNT);
+
+    piece_t selected_piece = s_board[g_src_square];
     if (get_color(selected_piece) != s_cur_turn) {
         printf("it's not your turn\n");
         return;
     }
 
-    node_t* movable_list = get_movable_list_or_null(s_board, g_src_coord);
-    print_list(movable_list);
+    move_list_t movable_list;
+    get_movable_list(s_board, &s_piece_list, &s_attack_map, g_src_square, &movable_list);
+    print_move_list(&movable_list);
 
-    node_t* p = movable_list;
-    while (p != NULL) {
-        if (p->x == dest_x && p->y == dest_y) {
-            move(s_board, src_x, src_y, dest_x, dest_y);
+    size_t i;
+    for (i = 0; i < movable_list.count; ++i) {
+        if (get_move_dest(movable_list.moves[i]) == g_dest_square) {
+            move(g_src_square, g_dest_square);
             break;
         }
-
-        p = p->next;
     }
 
-    if (p == NULL) {
+    if (i == movable_list.count) {
         printf("illegal moves\n\n");
     }
 
-    destroy_list(movable_list);
-
-    s_cur_turn = (s_cur_turn == COLOR_WHITE) ? COLOR_BLACK : COLOR_WHITE;
+    switch_turn();
 }
 
 void draw_board(void)
@@ -119,7 +231,7 @@ void draw_board(void)
         printf(" %s\n", VERTICAL_BOUNDARY);
 
         for (size_t x = 0; x < BOARD_WIDTH; ++x) {
-            piece_t piece = s_board[y][x];
+            piece_t piece = s_board[to_square(x, y)];
             shape_t shape = get_shape(piece);
             color_t color = get_color(piece);
             char display_name[3];
@@ -167,62 +279,230 @@ void draw_board(void)
         printf("%2s\n", HORIZONTAL_BOUNDARY);
     }
     printf(" %s\n", VERTICAL_BOUNDARY);
+    printf("evaluation: %d\n", get_evaluation());
+}
+
+int get_evaluation(void)
+{
+    int score = evaluate_board();
+
+    return (s_cur_turn == COLOR_WHITE) ? score : -score;
+}
+
+int evaluate_board(void)
+{
+    if (is_nnue_loaded()) {
+        return evaluate_nnue(&s_nnue_accumulator, s_cur_turn);
+    }
+
+    return evaluate(&s_evaluation, s_board, &s_piece_list, s_cur_turn);
+}
+
+const piece_t* get_board(void)
+{
+    return s_board;
+}
+
+color_t get_turn(void)
+{
+    return s_cur_turn;
+}
+
+hash_t get_hash(void)
+{
+    return s_hash;
+}
+
+// the network when one is loaded, the handcrafted evaluation otherwise
+hash_t get_evaluator_key(void)
+{
+    if (is_nnue_loaded()) {
+        return get_nnue_digest();
+    }
+
+    return 0x48414e44ULL * EVALUATION_VERSION;
+}
+
+const piece_list_t* get_piece_list(void)
+{
+    return &s_piece_list;
+}
+
+const attack_map_t* get_attack_map(void)
+{
+    return &s_attack_map;
+}
+
+int is_in_check(const color_t color)
+{
+    const color_t OTHER_COLOR = (color == COLOR_WHITE) ? COLOR_BLACK : COLOR_WHITE;
+
+    return is_attacked(&s_attack_map, s_piece_list.king_squares[get_color_index(color)], OTHER_COLOR);
+}
+
+void make_move(const move_t move_to_make, undo_t* out_undo)
+{
+    assert(out_undo != NULL);
+
+    const square_t SRC = get_move_src(move_to_make);
+    const square_t DEST = get_move_dest(move_to_make);
+
+    out_undo->move = move_to_make;
+    out_undo->moved_piece = s_board[SRC];
+    out_undo->captured_piece = s_board[DEST];
+
+    move(SRC, DEST);
+
+    switch_turn();
+}
+
+void unmake_move(const undo_t* undo)
+{
+    assert(undo != NULL);
+
+    const square_t SRC = get_move_src(undo->move);
+    const square_t DEST = get_move_dest(undo->move);
+
+    switch_turn();
+
+    remove_piece(DEST);
+    put_piece(SRC, undo->moved_piece);
+    if (undo->captured_piece != 0) {
+        put_piece(DEST, undo->captured_piece);
+    }
 }
 
 int is_checkmate(void) {
-    char coord[COORD_LENGTH];
+    move_list_t movable_list;
 
-    for (size_t y = 0; y < BOARD_HEIGHT; ++y) {
-        for (size_t x = 0; x < BOARD_WIDTH; ++x) {
-            color_t color = get_color(s_board[y][x]);
-            if (color == s_cur_turn) {
-                translate_to_coord(x, y, coord);
-                node_t* movable_list = get_movable_list_or_null(s_board, coord);
-                if (movable_list != NULL) {
-                    return FALSE;
-                }
-            }
+    size_t color_index = get_color_index(s_cur_turn);
+    for (size_t i = 0; i < s_piece_list.counts[color_index]; ++i) {
+        get_movable_list(s_board, &s_piece_list, &s_attack_map, s_piece_list.squares[color_index][i], &movable_list);
+        if (movable_list.count > 0) {
+            return FALSE;
         }
     }
 
     return TRUE;
 }
 
-size_t translate_to_board_x(const char* coord)
+square_t translate_to_square(const char* coord)
 {
     assert(coord != NULL);
     assert(is_valid_coord(coord));
 
-    return coord[0] - 'a';
+    return to_square(coord[0] - 'a', 7 - (coord[1] - '1'));
 }
 
-size_t translate_to_board_y(const char* coord)
+void translate_to_coord(const square_t square, char* out_coord)
 {
-    assert(coord != NULL);
-    assert(is_valid_coord(coord));
+    assert(square < SQUARE_COUNT);
+    assert(out_coord != NULL);
 
-    return 7 - (coord[1] - '1');
+    out_coord[0] = (char)get_square_x(square) + 'a';
+    out_coord[1] = '8' - (char)get_square_y(square);
+    out_coord[2] = '\0';
+    assert(is_valid_coord(out_coord));
 }
 
-void translate_to_coord(const size_t x, const size_t y, char* out_coord)
+static void move(const square_t src, const square_t dest)
 {
-    assert(is_valid_x(x));
-    assert(is_valid_y(y));
+    assert(src < SQUARE_COUNT);
+    assert(dest < SQUARE_COUNT);
 
-    out_coord[0] = (char)x + 'a';
-    out_coord[1] = '8' - (char)y;
-    out_coord[2] = '\0';
-    assert(is_valid_coord(out_coord));
+    piece_t piece = s_board[src];
+
+    if (s_board[dest] != 0) {
+        remove_piece(dest);
+    }
+    remove_piece(src);
+    put_piece(dest, piece | MOVE_FLAG);
+}
+
+// the board, the piece list, the attack map, the hash, the evaluation terms and the network accumulators change together
+static void put_piece(const square_t square, const piece_t piece)
+{
+    assert(square < SQUARE_COUNT);
+    assert(s_board[square] == 0);
+
+    remove_rays_through(&s_attack_map, s_board, square);
+    s_board[square] = piece;
+    add_piece_attacks(&s_attack_map, s_board, square);
+    s_hash ^= get_piece_key(piece, square);
+
+    add_to_piece_list(&s_piece_list, piece, square);
+    add_piece_evaluation(&s_evaluation, piece, square);
+    if (is_nnue_loaded()) {
+        add_piece_nnue(&s_nnue_accumulator, piece, square);
+    }
 }
 
-static void move(piece_t board[][BOARD_WIDTH], const size_t src_x, const size_t src_y, const size_t dest_x, const size_t dest_y)
+static void remove_piece(const square_t square)
 {
-    assert(board != NULL);
-    assert(is_valid_xy(src_x, src_y));
-    assert(is_valid_xy(dest_x, dest_y));
+    assert(square < SQUARE_COUNT);
+    assert(s_board[square] != 0);
+
+    piece_t piece = s_board[square];
+    remove_piece_attacks(&s_attack_map, s_board, square);
+    s_board[square] = 0;
+    add_rays_through(&s_attack_map, s_board, square);
+    s_hash ^= get_piece_key(piece, square);
+
+    remove_from_piece_list(&s_piece_list, piece, square);
+    remove_piece_evaluation(&s_evaluation, piece, square);
+    if (is_nnue_loaded()) {
+        remove_piece_nnue(&s_nnue_accumulator, piece, square);
+    }
+}
 
-    board[dest_y][dest_x] = board[src_y][src_x];
-    board[src_y][src_x] = 0;
+static void switch_turn(void)
+{
+    s_cur_turn = (s_cur_turn == COLOR_WHITE) ? COLOR_BLACK : COLOR_WHITE;
+    s_hash ^= get_turn_key();
+}
 
-    board[dest_y][dest_x] |= MOVE_FLAG;
+static void init_board_state(void)
+{
+    init_zobrist();
+    s_hash = (s_cur_turn == COLOR_BLACK) ? get_turn_key() : 0;
+    for (size_t square = 0; square < SQUARE_COUNT; ++square) {
+        if (s_board[square] != 0) {
+            s_hash ^= get_piece_key(s_board[square], (square_t)square);
+        }
+    }
+
+    init_piece_list(&s_piece_list, s_board);
+    init_attack_map(&s_attack_map, s_board, &s_piece_list);
+    init_evaluation(&s_evaluation, s_board);
+    if (is_nnue_loaded()) {
+        init_nnue_accumulator(&s_nnue_accumulator, s_board);
+    }
+}
+
+static piece_t get_fen_piece(const char symbol)
+{
+    color_t color = (symbol >= 'a' && symbol <= 'z') ? COLOR_BLACK : COLOR_WHITE;
+
+    switch (symbol) {
+    case 'K':
+    case 'k':
+        return SHAPE_KING | color;
+    case 'Q':
+    case 'q':
+        return SHAPE_QUEEN | color;
+    case 'R':
+    case 'r':
+        return SHAPE_ROOK | color;
+    case 'B':
+    case 'b':
+        return SHAPE_BISHOP | color;
+    case 'N':
+    case 'n':
+        return SHAPE_KNIGHT | color;
+    case 'P':
+    case 'p':
+        return SHAPE_PAWN | color;
+    default:
+        return 0;
+    }
 }
\ No newline at end of file
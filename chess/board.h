@@ -1,17 +1,40 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include "attack_map.h"
 #include "piece.h"
+#include "piece_list.h"
+#include "zobrist.h"
 #include "common_defines.h"
 
+typedef struct undo {
+	move_t move;
+	piece_t moved_piece;
+	piece_t captured_piece;
+} undo_t;
+
 void init_board(void);
+int load_fen(const char* fen);
 void update_board(void);
 void draw_board(void);
 
+int get_evaluation(void);
+int evaluate_board(void);
+
+const piece_t* get_board(void);
+color_t get_turn(void);
+hash_t get_hash(void);
+hash_t get_evaluator_key(void);
+const piece_list_t* get_piece_list(void);
+const attack_map_t* get_attack_map(void);
+int is_in_check(const color_t color);
+
+void make_move(const move_t move_to_make, undo_t* out_undo);
+void unmake_move(const undo_t* undo);
+
 int is_checkmate();
 
-size_t translate_to_board_x(const char* coord);
-size_t translate_to_board_y(const char* coord);
-void translate_to_coord(const size_t x, const size_t y, char* out_coord);
+square_t translate_to_square(const char* coord);
+void translate_to_coord(const square_t square, char* out_coord);
 
 #endif // BOARD_H
\ No newline at end of file
@@ -1,12 +1,19 @@
 #ifndef COMMON_DEFINES_H
 #define COMMON_DEFINES_H
 
+// <windows.h> may already have defined them
+#ifndef TRUE
 #define TRUE (1)
+#endif // TRUE
+
+#ifndef FALSE
 #define FALSE (0)
+#endif // FALSE
 
 #define COORD_LENGTH (3)
 
 #define BOARD_WIDTH (8)
 #define BOARD_HEIGHT (8)
+#define SQUARE_COUNT (BOARD_WIDTH * BOARD_HEIGHT)
 
 #endif // COMMON_DEFINES_H
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include <assert.h>
+#include <stddef.h>
+
+#include "evaluation.h"
+#include "validations.h"
+
+#define MAX_KING_ZONE_ATTACKS (9)
+
+// piece-square tables are written from white's point of view, a8 first
+static const int s_pawn_mg_table[SQUARE_COUNT] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     10,  10,  20,  30,  30,  20,  10,  10,
+      5,   5,  10,  25,  25,  10,   5,   5,
+      0,   0,   0,  20,  20,   0,   0,   0,
+      5,  -5, -10,   0,   0, -10,  -5,   5,
+      5,  10,  10, -20, -20,  10,  10,   5,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+static const int s_pawn_eg_table[SQUARE_COUNT] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     90,  90,  90,  90,  90,  90,  90,  90,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     30,  30,  30,  30,  30,  30,  30,  30,
+     15,  15,  15,  15,  15,  15,  15,  15,
+      5,   5,   5,   5,   5,   5,   5,   5,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+static const int s_knight_table[SQUARE_COUNT] = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   0,  15,  20,  20,  15,   0, -30,
+    -30,   5,  10,  15,  15,  10,   5, -30,
+    -40, -20,   0,   5,   5,   0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50
+};
+
+static const int s_bishop_table[SQUARE_COUNT] = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,   5,  10,  10,   5,   5, -10,
+    -10,   0,  10,  10,  10,  10,   0, -10,
+    -10,  10,  10,  10,  10,  10,  10, -10,
+    -10,   5,   0,   0,   0,   0,   5, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20
+};
+
+static const int s_rook_table[SQUARE_COUNT] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+      5,  10,  10,  10,  10,  10,  10,   5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+      0,   0,   0,   5,   5,   0,   0,   0
+};
+
+static const int s_queen_table[SQUARE_COUNT] = {
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+      0,   0,   5,   5,   5,   5,   0,  -5,
+    -10,   5,   5,   5,   5,   5,   0, -10,
+    -10,   0,   5,   0,   0,   0,   0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20
+};
+
+static const int s_king_mg_table[SQUARE_COUNT] = {
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+     20,  20,   0,   0,   0,   0,  20,  20,
+     20,  30,  10,   0,   0,  10,  30,  20
+};
+
+static const int s_king_eg_table[SQUARE_COUNT] = {
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10,   0,   0, -10, -20, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -30,   0,   0,   0,   0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50
+};
+
+// indexed by get_shape_index()
+static const int* const s_mg_tables[SHAPE_COUNT] = {
+    s_pawn_mg_table, s_knight_table, s_bishop_table, s_rook_table, s_queen_table, s_king_mg_table
+};
+static const int* const s_eg_tables[SHAPE_COUNT] = {
+    s_pawn_eg_table, s_knight_table, s_bishop_table, s_rook_table, s_queen_table, s_king_eg_table
+};
+
+static const int s_material_mg[SHAPE_COUNT] = { 82, 337, 365, 477, 1025, 0 };
+static const int s_material_eg[SHAPE_COUNT] = { 94, 281, 297, 512, 936, 0 };
+static const int s_phase_weights[SHAPE_COUNT] = { 0, 1, 1, 2, 4, 0 };
+
+// score per reachable square, relative to an average mobility
+static const int s_mobility_mg[SHAPE_COUNT] = { 0, 4, 5, 2, 1, 0 };
+static const int s_mobility_eg[SHAPE_COUNT] = { 0, 4, 5, 4, 2, 0 };
+static const int s_mobility_base[SHAPE_COUNT] = { 0, 4, 7, 7, 14, 0 };
+
+static const int s_king_zone_penalties[MAX_KING_ZONE_ATTACKS + 1] = { 0, 5, 15, 30, 50, 75, 100, 130, 160, 200 };
+
+static size_t get_table_index(const color_t color, const square_t square);
+static size_t count_mobility(const piece_t board[], const square_t square,
+    const int offsets[][2], const size_t offset_count, const int b_slide,
+    const size_t king_x, const size_t king_y, size_t* out_king_zone_attacks);
+static int is_in_king_zone(const size_t x, const size_t y, const size_t king_x, const size_t king_y);
+static int get_pawn_shield(const piece_t board[], const color_t color, const size_t king_x, const size_t king_y);
+
+void init_evaluation(evaluation_t* evaluation, const piece_t board[])
+{
+    assert(evaluation != NULL);
+    assert(board != NULL);
+
+    for (size_t i = 0; i < COLOR_COUNT; ++i) {
+        evaluation->mg_scores[i] = 0;
+        evaluation->eg_scores[i] = 0;
+    }
+    evaluation->phase = 0;
+
+    for (size_t square = 0; square < SQUARE_COUNT; ++square) {
+        if (board[square] != 0) {
+            add_piece_evaluation(evaluation, board[square], (square_t)square);
+        }
+    }
+}
+
+void add_piece_evaluation(evaluation_t* evaluation, const piece_t piece, const square_t square)
+{
+    assert(evaluation != NULL);
+    assert(square < SQUARE_COUNT);
+
+    color_t color = get_color(piece);
+    size_t color_index = get_color_index(color);
+    size_t shape_index = get_shape_index(get_shape(piece));
+    size_t table_index = get_table_index(color, square);
+
+    evaluation->mg_scores[color_index] += s_material_mg[shape_index] + s_mg_tables[shape_index][table_index];
+    evaluation->eg_scores[color_index] += s_material_eg[shape_index] + s_eg_tables[shape_index][table_index];
+    evaluation->phase += s_phase_weights[shape_index];
+}
+
+void remove_piece_evaluation(evaluation_t* evaluation, const piece_t piece, const square_t square)
+{
+    assert(evaluation != NULL);
+    assert(square < SQUARE_COUNT);
+
+    color_t color = get_color(piece);
+    size_t color_index = get_color_index(color);
+    size_t shape_index = get_shape_index(get_shape(piece));
+    size_t table_index = get_table_index(color, square);
+
+    evaluation->mg_scores[color_index] -= s_material_mg[shape_index] + s_mg_tables[shape_index][table_index];
+    evaluation->eg_scores[color_index] -= s_material_eg[shape_index] + s_eg_tables[shape_index][table_index];
+    evaluation->phase -= s_phase_weights[shape_index];
+}
+
+// material and piece-square terms come from the incremental scores,
+// mobility and king safety depend on the whole position and are added here
+int evaluate(const evaluation_t* evaluation, const piece_t board[], const piece_list_t* piece_list, const color_t turn)
+{
+    assert(evaluation != NULL);
+    assert(board != NULL);
+    assert(piece_list != NULL);
+
+    int mg_scores[COLOR_COUNT];
+    int eg_scores[COLOR_COUNT];
+    size_t king_x[COLOR_COUNT];
+    size_t king_y[COLOR_COUNT];
+    size_t king_zone_attacks[COLOR_COUNT] = { 0, };
+
+    for (size_t i = 0; i < COLOR_COUNT; ++i) {
+        mg_scores[i] = evaluation->mg_scores[i];
+        eg_scores[i] = evaluation->eg_scores[i];
+        king_x[i] = get_square_x(piece_list->king_squares[i]);
+        king_y[i] = get_square_y(piece_list->king_squares[i]);
+    }
+
+    // mobility
+    for (size_t color_index = 0; color_index < COLOR_COUNT; ++color_index) {
+        for (size_t i = 0; i < piece_list->counts[color_index]; ++i) {
+            square_t square = piece_list->squares[color_index][i];
+            piece_t piece = board[square];
+            shape_t shape = get_shape(piece);
+            if (shape == SHAPE_PAWN || shape == SHAPE_KING) {
+                continue;
+            }
+
+            size_t other_index = 1 - color_index;
+            size_t* zone_attacks = &king_zone_attacks[other_index];
+            size_t mobility = 0;
+
+            switch (shape) {
+            case SHAPE_KNIGHT:
+                mobility = count_mobility(board, square, g_knight_offsets, KNIGHT_OFFSET_COUNT, FALSE, king_x[other_index], king_y[other_index], zone_attacks);
+                break;
+            case SHAPE_BISHOP:
+                mobility = count_mobility(board, square, g_bishop_offsets, BISHOP_OFFSET_COUNT, TRUE, king_x[other_index], king_y[other_index], zone_attacks);
+                break;
+            case SHAPE_ROOK:
+                mobility = count_mobility(board, square, g_rook_offsets, ROOK_OFFSET_COUNT, TRUE, king_x[other_index], king_y[other_index], zone_attacks);
+                break;
+            case SHAPE_QUEEN:
+                mobility = count_mobility(board, square, g_bishop_offsets, BISHOP_OFFSET_COUNT, TRUE, king_x[other_index], king_y[other_index], zone_attacks)
+                    + count_mobility(board, square, g_rook_offsets, ROOK_OFFSET_COUNT, TRUE, king_x[other_index], king_y[other_index], zone_attacks);
+                break;
+            default:
+                assert(FALSE && "invalid shape");
+                break;
+            }
+
+            size_t shape_index = get_shape_index(shape);
+            int relative_mobility = (int)mobility - s_mobility_base[shape_index];
+            mg_scores[color_index] += relative_mobility * s_mobility_mg[shape_index];
+            eg_scores[color_index] += relative_mobility * s_mobility_eg[shape_index];
+        }
+    }
+
+    // king safety only matters while there is material left to attack with
+    for (size_t i = 0; i < COLOR_COUNT; ++i) {
+        color_t color = (i == 0) ? COLOR_WHITE : COLOR_BLACK;
+        size_t attacks = king_zone_attacks[i];
+        if (attacks > MAX_KING_ZONE_ATTACKS) {
+            attacks = MAX_KING_ZONE_ATTACKS;
+        }
+
+        mg_scores[i] += get_pawn_shield(board, color, king_x[i], king_y[i]);
+        mg_scores[i] -= s_king_zone_penalties[attacks];
+    }
+
+    int phase = evaluation->phase;
+    if (phase > MAX_PHASE) {
+        phase = MAX_PHASE;
+    }
+
+    int mg_score = mg_scores[0] - mg_scores[1];
+    int eg_score = eg_scores[0] - eg_scores[1];
+    int score = (mg_score * phase + eg_score * (MAX_PHASE - phase)) / MAX_PHASE;
+
+    return (turn == COLOR_WHITE) ? score : -score;
+}
+
+static size_t get_table_index(const color_t color, const square_t square)
+{
+    return (color == COLOR_WHITE) ? square : flip_square(square);
+}
+
+static size_t count_mobility(const piece_t board[], const square_t square,
+    const int offsets[][2], const size_t offset_count, const int b_slide,
+    const size_t king_x, const size_t king_y, size_t* out_king_zone_attacks)
+{
+    assert(board != NULL);
+    assert(offsets != NULL);
+    assert(out_king_zone_attacks != NULL);
+
+    size_t x = get_square_x(square);
+    size_t y = get_square_y(square);
+    color_t color = get_color(board[square]);
+    size_t mobility = 0;
+
+    for (size_t i = 0; i < offset_count; ++i) {
+        square_t ray[MAX_RAY_LENGTH];
+        size_t ray_length = get_ray_squares(board, x, y, offsets[i], b_slide, ray);
+
+        for (size_t j = 0; j < ray_length; ++j) {
+            if (get_color(board[ray[j]]) != color) {
+                ++mobility;
+            }
+
+            if (is_in_king_zone(get_square_x(ray[j]), get_square_y(ray[j]), king_x, king_y)) {
+                ++*out_king_zone_attacks;
+            }
+        }
+    }
+
+    return mobility;
+}
+
+static int is_in_king_zone(const size_t x, const size_t y, const size_t king_x, const size_t king_y)
+{
+    return (x + 1 >= king_x && x <= king_x + 1
+        && y + 1 >= king_y && y <= king_y + 1);
+}
+
+static int get_pawn_shield(const piece_t board[], const color_t color, const size_t king_x, const size_t king_y)
+{
+    const int NEAR_SHIELD_BONUS = 12;
+    const int FAR_SHIELD_BONUS = 6;
+
+    const piece_t PAWN = SHAPE_PAWN | color;
+    const int direction = (color == COLOR_WHITE) ? -1 : 1;
+
+    int bonus = 0;
+    for (size_t x = king_x - 1; x != king_x + 2; ++x) {
+        size_t near_y = king_y + direction;
+        size_t far_y = near_y + direction;
+
+        if (is_valid_xy(x, near_y) && (board[to_square(x, near_y)] & ~MOVE_FLAG) == PAWN) {
+            bonus += NEAR_SHIELD_BONUS;
+        }
+        else if (is_valid_xy(x, far_y) && (board[to_square(x, far_y)] & ~MOVE_FLAG) == PAWN) {
+            bonus += FAR_SHIELD_BONUS;
+        }
+    }
+
+    return bonus;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "common_defines.h"
+#include "piece.h"
+#include "piece_list.h"
+
+#define MAX_PHASE (24)
+
+// a mate found n plies from the root scores MATE_SCORE - n, so an evaluation stays below that range
+#define MAX_PLY (64)
+#define MATE_SCORE (30000)
+#define MAX_EVALUATION_SCORE (MATE_SCORE - MAX_PLY - 1)
+
+// bump when the handcrafted evaluation changes, earlier analysis no longer matches it
+#define EVALUATION_VERSION (1)
+
+typedef struct evaluation {
+	int mg_scores[COLOR_COUNT];
+	int eg_scores[COLOR_COUNT];
+	int phase;
+} evaluation_t;
+
+void init_evaluation(evaluation_t* evaluation, const piece_t board[]);
+void add_piece_evaluation(evaluation_t* evaluation, const piece_t piece, const square_t square);
+void remove_piece_evaluation(evaluation_t* evaluation, const piece_t piece, const square_t square);
+
+int evaluate(const evaluation_t* evaluation, const piece_t board[], const piece_list_t* piece_list, const color_t turn);
+
+#endif // EVALUATION_H
\ No newline at end of file
@@ -1,11 +1,33 @@
 #include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "game.h"
+#include "analysis.h"
+#include "analysis_cache.h"
 #include "board.h"
 #include "input.h"
+#include "nnue.h"
+#include "search.h"
 
-int main(void)
+// #define HINT_MODE
+
+#ifdef HINT_MODE
+#define HINT_DEPTH (4)
+
+static void draw_hint(void);
+#endif // HINT_MODE
+
+static int run_analysis(int argc, char* argv[]);
+
+// chess analyze <fen|startpos> [depth] [lines] streams the analysis of one position instead of playing
+int main(int argc, char* argv[])
 {
+    if (argc > 1 && strcmp(argv[1], "analyze") == 0) {
+        return run_analysis(argc, argv) ? 0 : 1;
+    }
+
     int b_running = TRUE;
 
     init_game();
@@ -24,7 +46,42 @@ int main(void)
 
 void init_game(void)
 {
+    // the handcrafted evaluation is used when there is no network file
+    load_nnue(NNUE_FILE_NAME);
     init_board();
+
+#ifdef HINT_MODE
+    // hints start from whatever earlier runs already searched
+    open_analysis_cache(ANALYSIS_CACHE_FILE_NAME, get_evaluator_key());
+#endif // HINT_MODE
+}
+
+static int run_analysis(int argc, char* argv[])
+{
+    if (argc < 3 || argc > 5) {
+        fprintf(stderr, "usage: %s analyze <fen|startpos> [depth] [lines]\n", argv[0]);
+        return FALSE;
+    }
+
+    const char* fen_or_null = (strcmp(argv[2], "startpos") == 0) ? NULL : argv[2];
+    int depth = (argc > 3) ? atoi(argv[3]) : DEFAULT_ANALYSIS_DEPTH;
+    int line_count = (argc > 4) ? atoi(argv[4]) : DEFAULT_ANALYSIS_LINE_COUNT;
+
+    if (depth <= 0 || depth >= MAX_PLY || line_count <= 0) {
+        fprintf(stderr, "depth must be between 1 and %d, lines at least 1\n", MAX_PLY - 1);
+        return FALSE;
+    }
+
+    load_nnue(NNUE_FILE_NAME);
+
+    // repeated runs on the same positions start from what the earlier ones searched
+    open_analysis_cache(ANALYSIS_CACHE_FILE_NAME, get_evaluator_key());
+
+    int b_analyzed = analyze(fen_or_null, (size_t)depth, (size_t)line_count);
+
+    close_analysis_cache();
+
+    return b_analyzed;
 }
 
 void update_game(void)
@@ -35,4 +92,28 @@ void update_game(void)
 void draw_game(void)
 {
     draw_board();
-}
\ No newline at end of file
+
+#ifdef HINT_MODE
+    draw_hint();
+#endif // HINT_MODE
+}
+
+#ifdef HINT_MODE
+static void draw_hint(void)
+{
+    search_result_t result;
+    search(HINT_DEPTH, &result);
+
+    if (!result.b_has_best_move) {
+        return;
+    }
+
+    char src_coord[COORD_LENGTH];
+    char dest_coord[COORD_LENGTH];
+    translate_to_coord(get_move_src(result.best_move), src_coord);
+    translate_to_coord(get_move_dest(result.best_move), dest_coord);
+
+    printf("hint: %s %s (score: %d, depth: %u, nodes: %llu)\n",
+        src_coord, dest_coord, result.score, (unsigned int)result.depth, result.node_count);
+}
+#endif // HINT_MODE
\ No newline at end of file
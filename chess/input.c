@@ -5,35 +5,38 @@
 #include <stdlib.h>
 
 #include "input.h"
+#include "board.h"
 #include "validations.h"
 
 // #define REDIRECTION_MODE
 
-char g_src_coord[COORD_LENGTH];
-char g_dest_coord[COORD_LENGTH];
+square_t g_src_square;
+square_t g_dest_square;
 
-static int input_coord(char* coord);
+static int input_square(square_t* out_square);
 
 void input(void)
 {
     printf("from coordinates\n> ");
-    if (input_coord(g_src_coord) == FALSE) {
+    if (input_square(&g_src_square) == FALSE) {
         fprintf(stderr, "failed read data");
         assert(FALSE && "failed read data");
     }
 
     printf("to coordinates\n> ");
-    if (input_coord(g_dest_coord) == FALSE) {
+    if (input_square(&g_dest_square) == FALSE) {
         fprintf(stderr, "failed read data");
         assert(FALSE && "failed read data");
     }
 }
 
-static int input_coord(char* coord)
+// coordinates are strings only here, everything past input works on squares
+static int input_square(square_t* out_square)
 {
-    assert(coord != NULL);
+    assert(out_square != NULL);
 
     char line[COORD_LENGTH];
+    char coord[COORD_LENGTH];
     while (TRUE) {
         if (fgets(line, COORD_LENGTH, stdin) == NULL) {
             clearerr(stdin);
@@ -42,6 +45,7 @@ static int input_coord(char* coord)
 
         if (sscanf(line, "%s", coord) == 1) {
             if (is_valid_coord(coord)) {
+                *out_square = translate_to_square(coord);
 #ifndef REDIRECTION_MODE
                 rewind(stdin);
 #endif // REDIRECTION_MODE
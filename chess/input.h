@@ -2,9 +2,10 @@
 #define INPUT_H
 
 #include "common_defines.h"
+#include "move.h"
 
-extern char g_src_coord[COORD_LENGTH];
-extern char g_dest_coord[COORD_LENGTH];
+extern square_t g_src_square;
+extern square_t g_dest_square;
 
 void input(void);
 
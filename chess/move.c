@@ -0,0 +1,96 @@
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "move.h"
+#include "board.h"
+#include "validations.h"
+
+square_t to_square(const size_t x, const size_t y)
+{
+    assert(is_valid_xy(x, y));
+
+    return (square_t)(y * BOARD_WIDTH + x);
+}
+
+size_t get_square_x(const square_t square)
+{
+    return square % BOARD_WIDTH;
+}
+
+size_t get_square_y(const square_t square)
+{
+    return square / BOARD_WIDTH;
+}
+
+// the same file seen from the other side of the board
+square_t flip_square(const square_t square)
+{
+    return square ^ ((BOARD_HEIGHT - 1) * BOARD_WIDTH);
+}
+
+move_t encode_move(const square_t src, const square_t dest, const unsigned int kind)
+{
+    assert(src < SQUARE_COUNT);
+    assert(dest < SQUARE_COUNT);
+
+    return (move_t)(src | (dest << MOVE_SQUARE_BITS) | ((kind & MOVE_KIND_MASK) << MOVE_KIND_SHIFT));
+}
+
+square_t get_move_src(const move_t move)
+{
+    return (square_t)(move & MOVE_SQUARE_MASK);
+}
+
+square_t get_move_dest(const move_t move)
+{
+    return (square_t)((move >> MOVE_SQUARE_BITS) & MOVE_SQUARE_MASK);
+}
+
+unsigned int get_move_promotion(const move_t move)
+{
+    return (move >> MOVE_PROMOTION_SHIFT) & MOVE_PROMOTION_MASK;
+}
+
+unsigned int get_move_kind(const move_t move)
+{
+    return (move >> MOVE_KIND_SHIFT) & MOVE_KIND_MASK;
+}
+
+int is_capture_move(const move_t move)
+{
+    return (get_move_kind(move) & MOVE_KIND_CAPTURE) != 0;
+}
+
+void add_move(move_list_t* move_list, const move_t move)
+{
+    assert(move_list != NULL);
+    assert(move_list->count < MAX_MOVES);
+
+    move_list->moves[move_list->count++] = move;
+}
+
+int contains_move(const move_list_t* move_list, const move_t move)
+{
+    assert(move_list != NULL);
+
+    for (size_t i = 0; i < move_list->count; ++i) {
+        if (move_list->moves[i] == move) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+void print_move_list(const move_list_t* move_list)
+{
+    assert(move_list != NULL);
+
+    char coord[COORD_LENGTH];
+    for (size_t i = 0; i < move_list->count; ++i) {
+        translate_to_coord(get_move_dest(move_list->moves[i]), coord);
+        printf("(%s) ", coord);
+    }
+    printf("\n");
+}
\ No newline at end of file
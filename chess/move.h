@@ -0,0 +1,46 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include "common_defines.h"
+
+#define MAX_MOVES (256)
+
+// from | to << 6 | promotion << 12 | kind << 14
+#define MOVE_SQUARE_BITS (6)
+#define MOVE_SQUARE_MASK (0x3f)
+#define MOVE_PROMOTION_SHIFT (12)
+#define MOVE_PROMOTION_MASK (0x3)
+#define MOVE_KIND_SHIFT (14)
+#define MOVE_KIND_MASK (0x3)
+
+#define MOVE_KIND_CAPTURE (0x1)
+#define MOVE_KIND_PROMOTION (0x2)
+
+#define NO_MOVE ((move_t)0)
+
+// y * BOARD_WIDTH + x, a8 is 0 and h1 is 63
+typedef unsigned char square_t;
+typedef unsigned short move_t;
+
+typedef struct move_list {
+	move_t moves[MAX_MOVES];
+	size_t count;
+} move_list_t;
+
+square_t to_square(const size_t x, const size_t y);
+size_t get_square_x(const square_t square);
+size_t get_square_y(const square_t square);
+square_t flip_square(const square_t square);
+
+move_t encode_move(const square_t src, const square_t dest, const unsigned int kind);
+square_t get_move_src(const move_t move);
+square_t get_move_dest(const move_t move);
+unsigned int get_move_promotion(const move_t move);
+unsigned int get_move_kind(const move_t move);
+int is_capture_move(const move_t move);
+
+void add_move(move_list_t* move_list, const move_t move);
+int contains_move(const move_list_t* move_list, const move_t move);
+void print_move_list(const move_list_t* move_list);
+
+#endif // MOVE_H
\ No newline at end of file
@@ -0,0 +1,330 @@
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "move_picker.h"
+
+#define MAX_EXCHANGES (32)
+
+// indexed by get_shape_index()
+static const int s_piece_values[SHAPE_COUNT] = { 100, 320, 330, 500, 900, 20000 };
+
+static void generate_captures(move_picker_t* picker);
+static void generate_quiets(move_picker_t* picker);
+static int pick_best_scored_move(scored_move_t* moves, const size_t count, size_t* pindex, move_t* out_move);
+static int is_pseudo_legal(const move_picker_t* picker, const move_t move);
+static int is_picked_early(const move_picker_t* picker, const move_t move);
+static int get_piece_value(const piece_t piece);
+
+void init_move_picker(move_picker_t* picker, const piece_t board[], const piece_list_t* piece_list, const color_t turn,
+    const move_t* hash_move_or_null, const move_t* killers_or_null, const int history[][SQUARE_COUNT])
+{
+    assert(picker != NULL);
+    assert(board != NULL);
+    assert(piece_list != NULL);
+    assert(history != NULL);
+
+    picker->board = board;
+    picker->piece_list = piece_list;
+    picker->turn = turn;
+    picker->stage = PICK_STAGE_HASH_MOVE;
+    picker->b_captures_only = FALSE;
+
+    picker->b_has_hash_move = (hash_move_or_null != NULL);
+    picker->hash_move = (hash_move_or_null != NULL) ? *hash_move_or_null : NO_MOVE;
+
+    picker->killer_count = 0;
+    picker->killer_index = 0;
+    if (killers_or_null != NULL) {
+        memcpy(picker->killers, killers_or_null, sizeof(picker->killers));
+        picker->killer_count = KILLER_COUNT;
+    }
+    picker->history = history;
+
+    picker->capture_count = 0;
+    picker->capture_index = 0;
+    picker->bad_capture_count = 0;
+    picker->bad_capture_index = 0;
+    picker->quiet_count = 0;
+    picker->quiet_index = 0;
+}
+
+void init_capture_picker(move_picker_t* picker, const piece_t board[], const piece_list_t* piece_list, const color_t turn)
+{
+    assert(picker != NULL);
+    assert(board != NULL);
+    assert(piece_list != NULL);
+
+    picker->board = board;
+    picker->piece_list = piece_list;
+    picker->turn = turn;
+    picker->stage = PICK_STAGE_GENERATE_CAPTURES;
+    picker->b_captures_only = TRUE;
+
+    picker->b_has_hash_move = FALSE;
+    picker->hash_move = NO_MOVE;
+    picker->killer_count = 0;
+    picker->killer_index = 0;
+    picker->history = NULL;
+
+    picker->capture_count = 0;
+    picker->capture_index = 0;
+    picker->bad_capture_count = 0;
+    picker->bad_capture_index = 0;
+    picker->quiet_count = 0;
+    picker->quiet_index = 0;
+}
+
+// moves come out in stages and each stage is generated only when the previous one runs out,
+// so a cutoff on the hash move or a good capture never pays for quiet move generation
+int pick_next_move(move_picker_t* picker, move_t* out_move)
+{
+    assert(picker != NULL);
+    assert(out_move != NULL);
+
+    while (TRUE) {
+        switch (picker->stage) {
+        case PICK_STAGE_HASH_MOVE:
+            picker->stage = PICK_STAGE_GENERATE_CAPTURES;
+            if (picker->b_has_hash_move && is_pseudo_legal(picker, picker->hash_move)) {
+                *out_move = picker->hash_move;
+                return TRUE;
+            }
+            picker->b_has_hash_move = FALSE;
+            break;
+
+        case PICK_STAGE_GENERATE_CAPTURES:
+            generate_captures(picker);
+            picker->stage = PICK_STAGE_GOOD_CAPTURES;
+            break;
+
+        case PICK_STAGE_GOOD_CAPTURES:
+            while (pick_best_scored_move(picker->captures, picker->capture_count, &picker->capture_index, out_move)) {
+                if (is_picked_early(picker, *out_move)) {
+                    continue;
+                }
+
+                // losing captures are tried after the quiet moves
+                if (get_static_exchange(picker->board, *out_move) < 0) {
+                    picker->bad_captures[picker->bad_capture_count++] = *out_move;
+                    continue;
+                }
+
+                return TRUE;
+            }
+            picker->stage = picker->b_captures_only ? PICK_STAGE_DONE : PICK_STAGE_KILLERS;
+            break;
+
+        case PICK_STAGE_KILLERS:
+            while (picker->killer_index < picker->killer_count) {
+                move_t killer = picker->killers[picker->killer_index++];
+                if (!picker->b_has_hash_move || killer != picker->hash_move) {
+                    if (!is_capture_move(killer) && is_pseudo_legal(picker, killer)) {
+                        *out_move = killer;
+                        return TRUE;
+                    }
+                }
+            }
+            picker->stage = PICK_STAGE_GENERATE_QUIETS;
+            break;
+
+        case PICK_STAGE_GENERATE_QUIETS:
+            generate_quiets(picker);
+            picker->stage = PICK_STAGE_QUIETS;
+            break;
+
+        case PICK_STAGE_QUIETS:
+            while (pick_best_scored_move(picker->quiets, picker->quiet_count, &picker->quiet_index, out_move)) {
+                if (!is_picked_early(picker, *out_move)) {
+                    return TRUE;
+                }
+            }
+            picker->stage = PICK_STAGE_BAD_CAPTURES;
+            break;
+
+        case PICK_STAGE_BAD_CAPTURES:
+            if (picker->bad_capture_index < picker->bad_capture_count) {
+                *out_move = picker->bad_captures[picker->bad_capture_index++];
+                return TRUE;
+            }
+            picker->stage = PICK_STAGE_DONE;
+            break;
+
+        case PICK_STAGE_DONE:
+            return FALSE;
+
+        default:
+            assert(FALSE && "invalid pick stage");
+            return FALSE;
+        }
+    }
+}
+
+// swap algorithm: let both sides keep recapturing on the destination with their least valuable attacker,
+// then go back through the sequence letting either side stop when continuing would lose material
+int get_static_exchange(const piece_t board[], const move_t move)
+{
+    assert(board != NULL);
+
+    const square_t DEST = get_move_dest(move);
+
+    piece_t copied_board[SQUARE_COUNT];
+    memcpy(copied_board, board, SQUARE_COUNT * sizeof(piece_t));
+
+    int gains[MAX_EXCHANGES];
+    size_t depth = 0;
+    square_t attacker_square = get_move_src(move);
+    piece_t attacker = copied_board[attacker_square];
+    color_t side = get_color(attacker);
+
+    gains[0] = get_piece_value(copied_board[DEST]);
+
+    while (depth + 1 < MAX_EXCHANGES) {
+        ++depth;
+        gains[depth] = get_piece_value(attacker) - gains[depth - 1];
+
+        // neither side can gain from continuing
+        if (-gains[depth - 1] < 0 && gains[depth] < 0) {
+            break;
+        }
+
+        copied_board[attacker_square] = 0;
+        copied_board[DEST] = attacker;
+        side = (side == COLOR_WHITE) ? COLOR_BLACK : COLOR_WHITE;
+
+        if (!find_least_valuable_attacker(copied_board, DEST, side, &attacker_square)) {
+            break;
+        }
+        attacker = copied_board[attacker_square];
+    }
+
+    while (--depth > 0) {
+        int stop_gain = -gains[depth - 1];
+        gains[depth - 1] = -((stop_gain > gains[depth]) ? stop_gain : gains[depth]);
+    }
+
+    return gains[0];
+}
+
+static void generate_captures(move_picker_t* picker)
+{
+    assert(picker != NULL);
+
+    move_list_t capture_list;
+    capture_list.count = 0;
+
+    size_t color_index = get_color_index(picker->turn);
+    for (size_t i = 0; i < picker->piece_list->counts[color_index]; ++i) {
+        get_unchecked_capture_list(picker->board, picker->piece_list->squares[color_index][i], &capture_list);
+    }
+
+    // MVV-LVA: most valuable victim first, least valuable attacker breaks ties
+    for (size_t i = 0; i < capture_list.count; ++i) {
+        move_t move = capture_list.moves[i];
+        int attacker_index = (int)get_shape_index(get_shape(picker->board[get_move_src(move)]));
+
+        scored_move_t* scored_move = &picker->captures[picker->capture_count++];
+        scored_move->move = move;
+        scored_move->score = get_piece_value(picker->board[get_move_dest(move)]) - attacker_index;
+    }
+}
+
+static void generate_quiets(move_picker_t* picker)
+{
+    assert(picker != NULL);
+
+    move_list_t quiet_list;
+    quiet_list.count = 0;
+
+    size_t color_index = get_color_index(picker->turn);
+    for (size_t i = 0; i < picker->piece_list->counts[color_index]; ++i) {
+        get_unchecked_quiet_list(picker->board, picker->piece_list->squares[color_index][i], &quiet_list);
+    }
+
+    for (size_t i = 0; i < quiet_list.count; ++i) {
+        move_t move = quiet_list.moves[i];
+
+        scored_move_t* scored_move = &picker->quiets[picker->quiet_count++];
+        scored_move->move = move;
+        scored_move->score = picker->history[get_move_src(move)][get_move_dest(move)];
+    }
+}
+
+// selection sort one step at a time; a cutoff usually comes long before the list is sorted
+static int pick_best_scored_move(scored_move_t* moves, const size_t count, size_t* pindex, move_t* out_move)
+{
+    assert(moves != NULL);
+    assert(pindex != NULL);
+    assert(out_move != NULL);
+
+    size_t index = *pindex;
+    if (index >= count) {
+        return FALSE;
+    }
+
+    size_t best_index = index;
+    for (size_t i = index + 1; i < count; ++i) {
+        if (moves[i].score > moves[best_index].score) {
+            best_index = i;
+        }
+    }
+
+    scored_move_t best = moves[best_index];
+    moves[best_index] = moves[index];
+    moves[index] = best;
+
+    *out_move = best.move;
+    *pindex = index + 1;
+
+    return TRUE;
+}
+
+static int is_pseudo_legal(const move_picker_t* picker, const move_t move)
+{
+    assert(picker != NULL);
+
+    square_t src = get_move_src(move);
+    if (get_color(picker->board[src]) != picker->turn) {
+        return FALSE;
+    }
+
+    // the kind bits are part of the move, so a stale capture does not match a quiet move and vice versa
+    move_list_t movable_list;
+    movable_list.count = 0;
+    if (is_capture_move(move)) {
+        get_unchecked_capture_list(picker->board, src, &movable_list);
+    }
+    else {
+        get_unchecked_quiet_list(picker->board, src, &movable_list);
+    }
+
+    return contains_move(&movable_list, move);
+}
+
+// the hash move and the killers were already returned by their own stages
+static int is_picked_early(const move_picker_t* picker, const move_t move)
+{
+    assert(picker != NULL);
+
+    if (picker->b_has_hash_move && move == picker->hash_move) {
+        return TRUE;
+    }
+
+    for (size_t i = 0; i < picker->killer_index; ++i) {
+        if (move == picker->killers[i]) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static int get_piece_value(const piece_t piece)
+{
+    if (piece == 0) {
+        return 0;
+    }
+
+    return s_piece_values[get_shape_index(get_shape(piece))];
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+#include "common_defines.h"
+#include "move.h"
+#include "piece.h"
+#include "piece_list.h"
+
+#define KILLER_COUNT (2)
+
+typedef enum pick_stage {
+	PICK_STAGE_HASH_MOVE,
+	PICK_STAGE_GENERATE_CAPTURES,
+	PICK_STAGE_GOOD_CAPTURES,
+	PICK_STAGE_KILLERS,
+	PICK_STAGE_GENERATE_QUIETS,
+	PICK_STAGE_QUIETS,
+	PICK_STAGE_BAD_CAPTURES,
+	PICK_STAGE_DONE
+} pick_stage_t;
+
+typedef struct scored_move {
+	move_t move;
+	int score;
+} scored_move_t;
+
+typedef struct move_picker {
+	const piece_t* board;
+	const piece_list_t* piece_list;
+	color_t turn;
+	pick_stage_t stage;
+	int b_captures_only;
+
+	move_t hash_move;
+	int b_has_hash_move;
+	move_t killers[KILLER_COUNT];
+	size_t killer_count;
+	size_t killer_index;
+	const int (*history)[SQUARE_COUNT];
+
+	scored_move_t captures[MAX_MOVES];
+	size_t capture_count;
+	size_t capture_index;
+
+	move_t bad_captures[MAX_MOVES];
+	size_t bad_capture_count;
+	size_t bad_capture_index;
+
+	scored_move_t quiets[MAX_MOVES];
+	size_t quiet_count;
+	size_t quiet_index;
+} move_picker_t;
+
+void init_move_picker(move_picker_t* picker, const piece_t board[], const piece_list_t* piece_list, const color_t turn,
+    const move_t* hash_move_or_null, const move_t* killers_or_null, const int history[][SQUARE_COUNT]);
+void init_capture_picker(move_picker_t* picker, const piece_t board[], const piece_list_t* piece_list, const color_t turn);
+int pick_next_move(move_picker_t* picker, move_t* out_move);
+
+int get_static_exchange(const piece_t board[], const move_t move);
+
+#endif // MOVE_PICKER_H
\ No newline at end of file
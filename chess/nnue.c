@@ -0,0 +1,369 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nnue.h"
+#include "evaluation.h"
+#include "validations.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NNUE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif // _MSC_VER
+#endif // x86
+
+// weight file layout, all values little-endian:
+//   magic "CNUE", version (u32), hidden size (u32),
+//   feature weights (i16 [input][hidden]), feature biases (i16 [hidden]),
+//   output weights (i16 [2 * hidden]), output bias (i32)
+#define NNUE_MAGIC "CNUE"
+#define NNUE_VERSION (1)
+
+// quantization of the clipped hidden layer and the output layer
+#define NNUE_QA (255)
+#define NNUE_QB (64)
+#define NNUE_SCALE (400)
+
+typedef void (*update_weights_func_t)(short* values, const short* weights);
+typedef int (*dot_crelu_func_t)(const short* values, const short* weights);
+
+static short s_feature_weights[NNUE_INPUT_SIZE][NNUE_HIDDEN_SIZE];
+static short s_feature_biases[NNUE_HIDDEN_SIZE];
+static short s_output_weights[COLOR_COUNT * NNUE_HIDDEN_SIZE];
+static int s_output_bias;
+static unsigned long long s_digest;
+static int s_b_loaded = FALSE;
+
+static update_weights_func_t s_add_weights;
+static update_weights_func_t s_sub_weights;
+static dot_crelu_func_t s_dot_crelu;
+
+static void select_kernels(void);
+static unsigned long long get_digest(const unsigned long long digest, const void* data, const size_t size);
+static size_t get_feature_index(const color_t perspective, const piece_t piece, const square_t square);
+
+static void add_weights_scalar(short* values, const short* weights);
+static void sub_weights_scalar(short* values, const short* weights);
+static int dot_crelu_scalar(const short* values, const short* weights);
+
+#ifdef NNUE_X86
+static int is_avx2_supported(void);
+static int is_sse41_supported(void);
+
+static void add_weights_sse41(short* values, const short* weights);
+static void sub_weights_sse41(short* values, const short* weights);
+static int dot_crelu_sse41(const short* values, const short* weights);
+
+static void add_weights_avx2(short* values, const short* weights);
+static void sub_weights_avx2(short* values, const short* weights);
+static int dot_crelu_avx2(const short* values, const short* weights);
+#endif // NNUE_X86
+
+int load_nnue(const char* file_name)
+{
+    assert(file_name != NULL);
+
+    s_b_loaded = FALSE;
+
+    FILE* fp = fopen(file_name, "rb");
+    if (fp == NULL) {
+        return FALSE;
+    }
+
+    char magic[4];
+    unsigned int header[2];
+    int b_valid = fread(magic, sizeof(magic), 1, fp) == 1
+        && memcmp(magic, NNUE_MAGIC, sizeof(magic)) == 0
+        && fread(header, sizeof(header), 1, fp) == 1
+        && header[0] == NNUE_VERSION
+        && header[1] == NNUE_HIDDEN_SIZE
+        && fread(s_feature_weights, sizeof(s_feature_weights), 1, fp) == 1
+        && fread(s_feature_biases, sizeof(s_feature_biases), 1, fp) == 1
+        && fread(s_output_weights, sizeof(s_output_weights), 1, fp) == 1
+        && fread(&s_output_bias, sizeof(s_output_bias), 1, fp) == 1;
+
+    fclose(fp);
+
+    if (!b_valid) {
+        fprintf(stderr, "invalid network file: %s\n", file_name);
+        return FALSE;
+    }
+
+    s_digest = get_digest(0xcbf29ce484222325ULL, s_feature_weights, sizeof(s_feature_weights));
+    s_digest = get_digest(s_digest, s_feature_biases, sizeof(s_feature_biases));
+    s_digest = get_digest(s_digest, s_output_weights, sizeof(s_output_weights));
+    s_digest = get_digest(s_digest, &s_output_bias, sizeof(s_output_bias));
+
+    select_kernels();
+    s_b_loaded = TRUE;
+
+    return TRUE;
+}
+
+int is_nnue_loaded(void)
+{
+    return s_b_loaded;
+}
+
+// identifies the network, so analysis made with another one is not mistaken for its own
+unsigned long long get_nnue_digest(void)
+{
+    assert(s_b_loaded);
+
+    return s_digest;
+}
+
+void init_nnue_accumulator(nnue_accumulator_t* accumulator, const piece_t board[])
+{
+    assert(accumulator != NULL);
+    assert(board != NULL);
+    assert(s_b_loaded);
+
+    for (size_t i = 0; i < COLOR_COUNT; ++i) {
+        memcpy(accumulator->values[i], s_feature_biases, sizeof(s_feature_biases));
+    }
+
+    for (size_t square = 0; square < SQUARE_COUNT; ++square) {
+        if (board[square] != 0) {
+            add_piece_nnue(accumulator, board[square], (square_t)square);
+        }
+    }
+}
+
+void add_piece_nnue(nnue_accumulator_t* accumulator, const piece_t piece, const square_t square)
+{
+    assert(accumulator != NULL);
+    assert(square < SQUARE_COUNT);
+    assert(s_b_loaded);
+
+    s_add_weights(accumulator->values[0], s_feature_weights[get_feature_index(COLOR_WHITE, piece, square)]);
+    s_add_weights(accumulator->values[1], s_feature_weights[get_feature_index(COLOR_BLACK, piece, square)]);
+}
+
+void remove_piece_nnue(nnue_accumulator_t* accumulator, const piece_t piece, const square_t square)
+{
+    assert(accumulator != NULL);
+    assert(square < SQUARE_COUNT);
+    assert(s_b_loaded);
+
+    s_sub_weights(accumulator->values[0], s_feature_weights[get_feature_index(COLOR_WHITE, piece, square)]);
+    s_sub_weights(accumulator->values[1], s_feature_weights[get_feature_index(COLOR_BLACK, piece, square)]);
+}
+
+int evaluate_nnue(const nnue_accumulator_t* accumulator, const color_t turn)
+{
+    assert(accumulator != NULL);
+    assert(s_b_loaded);
+
+    size_t us = get_color_index(turn);
+    size_t them = 1 - us;
+
+    // each half fits in an int, their sum does not
+    long long output = (long long)s_dot_crelu(accumulator->values[us], s_output_weights)
+        + s_dot_crelu(accumulator->values[them], s_output_weights + NNUE_HIDDEN_SIZE);
+
+    long long score = (output + s_output_bias) * NNUE_SCALE / (NNUE_QA * NNUE_QB);
+
+    // whatever the network says, it is never read as a mate
+    if (score > MAX_EVALUATION_SCORE) {
+        return MAX_EVALUATION_SCORE;
+    }
+    else if (score < -MAX_EVALUATION_SCORE) {
+        return -MAX_EVALUATION_SCORE;
+    }
+
+    return (int)score;
+}
+
+static void select_kernels(void)
+{
+    s_add_weights = add_weights_scalar;
+    s_sub_weights = sub_weights_scalar;
+    s_dot_crelu = dot_crelu_scalar;
+
+#ifdef NNUE_X86
+    if (is_avx2_supported()) {
+        s_add_weights = add_weights_avx2;
+        s_sub_weights = sub_weights_avx2;
+        s_dot_crelu = dot_crelu_avx2;
+    }
+    else if (is_sse41_supported()) {
+        s_add_weights = add_weights_sse41;
+        s_sub_weights = sub_weights_sse41;
+        s_dot_crelu = dot_crelu_sse41;
+    }
+#endif // NNUE_X86
+}
+
+// FNV-1a
+static unsigned long long get_digest(const unsigned long long digest, const void* data, const size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+
+    unsigned long long result = digest;
+    for (size_t i = 0; i < size; ++i) {
+        result = (result ^ bytes[i]) * 0x100000001b3ULL;
+    }
+
+    return result;
+}
+
+// each side sees the board from its own point of view: own pieces first, ranks flipped for black
+static size_t get_feature_index(const color_t perspective, const piece_t piece, const square_t square)
+{
+    size_t relative_color = (get_color(piece) == perspective) ? 0 : 1;
+    square_t relative_square = (perspective == COLOR_WHITE) ? square : flip_square(square);
+
+    return (relative_color * SHAPE_COUNT + get_shape_index(get_shape(piece))) * SQUARE_COUNT + relative_square;
+}
+
+static void add_weights_scalar(short* values, const short* weights)
+{
+    for (size_t i = 0; i < NNUE_HIDDEN_SIZE; ++i) {
+        values[i] += weights[i];
+    }
+}
+
+static void sub_weights_scalar(short* values, const short* weights)
+{
+    for (size_t i = 0; i < NNUE_HIDDEN_SIZE; ++i) {
+        values[i] -= weights[i];
+    }
+}
+
+static int dot_crelu_scalar(const short* values, const short* weights)
+{
+    int sum = 0;
+    for (size_t i = 0; i < NNUE_HIDDEN_SIZE; ++i) {
+        int value = values[i];
+        if (value < 0) {
+            value = 0;
+        }
+        else if (value > NNUE_QA) {
+            value = NNUE_QA;
+        }
+
+        sum += value * weights[i];
+    }
+
+    return sum;
+}
+
+#ifdef NNUE_X86
+static int is_avx2_supported(void)
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return FALSE;
+    }
+
+    // the OS has to save the upper halves of the ymm registers
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 0x6) != 0x6) {
+        return FALSE;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif // _MSC_VER
+}
+
+static int is_sse41_supported(void)
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif // _MSC_VER
+}
+
+TARGET_SSE41 static void add_weights_sse41(short* values, const short* weights)
+{
+    for (size_t i = 0; i < NNUE_HIDDEN_SIZE; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(values + i));
+        __m128i w = _mm_loadu_si128((const __m128i*)(weights + i));
+        _mm_storeu_si128((__m128i*)(values + i), _mm_add_epi16(v, w));
+    }
+}
+
+TARGET_SSE41 static void sub_weights_sse41(short* values, const short* weights)
+{
+    for (size_t i = 0; i < NNUE_HIDDEN_SIZE; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(values + i));
+        __m128i w = _mm_loadu_si128((const __m128i*)(weights + i));
+        _mm_storeu_si128((__m128i*)(values + i), _mm_sub_epi16(v, w));
+    }
+}
+
+TARGET_SSE41 static int dot_crelu_sse41(const short* values, const short* weights)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i qa = _mm_set1_epi16(NNUE_QA);
+
+    __m128i sum = _mm_setzero_si128();
+    for (size_t i = 0; i < NNUE_HIDDEN_SIZE; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(values + i));
+        __m128i w = _mm_loadu_si128((const __m128i*)(weights + i));
+        v = _mm_min_epi16(_mm_max_epi16(v, zero), qa);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(v, w));
+    }
+
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+
+    return _mm_cvtsi128_si32(sum);
+}
+
+TARGET_AVX2 static void add_weights_avx2(short* values, const short* weights)
+{
+    for (size_t i = 0; i < NNUE_HIDDEN_SIZE; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+        __m256i w = _mm256_loadu_si256((const __m256i*)(weights + i));
+        _mm256_storeu_si256((__m256i*)(values + i), _mm256_add_epi16(v, w));
+    }
+}
+
+TARGET_AVX2 static void sub_weights_avx2(short* values, const short* weights)
+{
+    for (size_t i = 0; i < NNUE_HIDDEN_SIZE; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+        __m256i w = _mm256_loadu_si256((const __m256i*)(weights + i));
+        _mm256_storeu_si256((__m256i*)(values + i), _mm256_sub_epi16(v, w));
+    }
+}
+
+TARGET_AVX2 static int dot_crelu_avx2(const short* values, const short* weights)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qa = _mm256_set1_epi16(NNUE_QA);
+
+    __m256i sum = _mm256_setzero_si256();
+    for (size_t i = 0; i < NNUE_HIDDEN_SIZE; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+        __m256i w = _mm256_loadu_si256((const __m256i*)(weights + i));
+        v = _mm256_min_epi16(_mm256_max_epi16(v, zero), qa);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, w));
+    }
+
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4e));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xb1));
+
+    return _mm_cvtsi128_si32(half);
+}
+#endif // NNUE_X86
\ No newline at end of file
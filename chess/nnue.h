@@ -0,0 +1,26 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include "common_defines.h"
+#include "piece.h"
+
+#define NNUE_FILE_NAME "chess.nnue"
+
+#define NNUE_INPUT_SIZE (COLOR_COUNT * SHAPE_COUNT * SQUARE_COUNT)
+#define NNUE_HIDDEN_SIZE (256)
+
+typedef struct nnue_accumulator {
+	short values[COLOR_COUNT][NNUE_HIDDEN_SIZE];
+} nnue_accumulator_t;
+
+int load_nnue(const char* file_name);
+int is_nnue_loaded(void);
+unsigned long long get_nnue_digest(void);
+
+void init_nnue_accumulator(nnue_accumulator_t* accumulator, const piece_t board[]);
+void add_piece_nnue(nnue_accumulator_t* accumulator, const piece_t piece, const square_t square);
+void remove_piece_nnue(nnue_accumulator_t* accumulator, const piece_t piece, const square_t square);
+
+int evaluate_nnue(const nnue_accumulator_t* accumulator, const color_t turn);
+
+#endif // NNUE_H
\ No newline at end of file
@@ -0,0 +1,220 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif // _WIN32
+
+#include "output_queue.h"
+
+// the search only copies text into a ring buffer under a short lock,
+// a writer thread takes it out in batches and does the blocking writes.
+// when a slow reader lets the buffer fill up, new text is dropped rather than stalling the search
+static FILE* s_stream = NULL;
+
+static char s_buffer[OUTPUT_QUEUE_SIZE];
+static size_t s_read_count;
+static size_t s_write_count;
+static size_t s_dropped_count;
+static int s_b_stopping;
+
+// only the writer thread touches the batch
+static char s_batch[OUTPUT_QUEUE_SIZE];
+
+#ifdef _WIN32
+static CRITICAL_SECTION s_lock;
+static CONDITION_VARIABLE s_ready;
+static HANDLE s_writer;
+
+static DWORD WINAPI run_writer(LPVOID param);
+#else
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_ready = PTHREAD_COND_INITIALIZER;
+static pthread_t s_writer;
+
+static void* run_writer(void* param);
+#endif // _WIN32
+
+static void write_batches(void);
+static void lock_queue(void);
+static void unlock_queue(void);
+static void wait_queue(void);
+static void signal_queue(void);
+
+int start_output_queue(FILE* stream)
+{
+    assert(stream != NULL);
+    assert(s_stream == NULL);
+
+    s_read_count = 0;
+    s_write_count = 0;
+    s_dropped_count = 0;
+    s_b_stopping = FALSE;
+
+    s_stream = stream;
+
+#ifdef _WIN32
+    InitializeCriticalSection(&s_lock);
+    InitializeConditionVariable(&s_ready);
+
+    s_writer = CreateThread(NULL, 0, run_writer, NULL, 0, NULL);
+    if (s_writer == NULL) {
+        DeleteCriticalSection(&s_lock);
+        s_stream = NULL;
+        return FALSE;
+    }
+#else
+    if (pthread_create(&s_writer, NULL, run_writer, NULL) != 0) {
+        s_stream = NULL;
+        return FALSE;
+    }
+#endif // _WIN32
+
+    return TRUE;
+}
+
+// without a running queue the text is written directly
+void push_output(const char* text)
+{
+    assert(text != NULL);
+
+    if (s_stream == NULL) {
+        fputs(text, stdout);
+        fflush(stdout);
+        return;
+    }
+
+    size_t length = strlen(text);
+
+    lock_queue();
+    if (length > OUTPUT_QUEUE_SIZE - (s_write_count - s_read_count)) {
+        ++s_dropped_count;
+    }
+    else {
+        size_t offset = s_write_count % OUTPUT_QUEUE_SIZE;
+        size_t first_length = (length < OUTPUT_QUEUE_SIZE - offset) ? length : OUTPUT_QUEUE_SIZE - offset;
+
+        memcpy(s_buffer + offset, text, first_length);
+        memcpy(s_buffer, text + first_length, length - first_length);
+        s_write_count += length;
+
+        signal_queue();
+    }
+    unlock_queue();
+}
+
+// everything pushed so far is written out before the writer thread ends
+void stop_output_queue(void)
+{
+    if (s_stream == NULL) {
+        return;
+    }
+
+    lock_queue();
+    s_b_stopping = TRUE;
+    signal_queue();
+    unlock_queue();
+
+#ifdef _WIN32
+    WaitForSingleObject(s_writer, INFINITE);
+    CloseHandle(s_writer);
+    DeleteCriticalSection(&s_lock);
+#else
+    pthread_join(s_writer, NULL);
+#endif // _WIN32
+
+    if (s_dropped_count > 0) {
+        fprintf(stderr, "output queue was full, dropped %u pushes\n", (unsigned int)s_dropped_count);
+    }
+
+    s_stream = NULL;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI run_writer(LPVOID param)
+{
+    (void)param;
+    write_batches();
+
+    return 0;
+}
+#else
+static void* run_writer(void* param)
+{
+    (void)param;
+    write_batches();
+
+    return NULL;
+}
+#endif // _WIN32
+
+static void write_batches(void)
+{
+    while (TRUE) {
+        size_t length;
+
+        lock_queue();
+        while (s_write_count == s_read_count && !s_b_stopping) {
+            wait_queue();
+        }
+
+        length = s_write_count - s_read_count;
+
+        size_t offset = s_read_count % OUTPUT_QUEUE_SIZE;
+        size_t first_length = (length < OUTPUT_QUEUE_SIZE - offset) ? length : OUTPUT_QUEUE_SIZE - offset;
+
+        memcpy(s_batch, s_buffer + offset, first_length);
+        memcpy(s_batch + first_length, s_buffer, length - first_length);
+        s_read_count += length;
+        unlock_queue();
+
+        if (length == 0) {
+            break;
+        }
+
+        // a reader that wants each iteration as soon as it is done gets it without waiting for a full stdio buffer
+        fwrite(s_batch, 1, length, s_stream);
+        fflush(s_stream);
+    }
+}
+
+static void lock_queue(void)
+{
+#ifdef _WIN32
+    EnterCriticalSection(&s_lock);
+#else
+    pthread_mutex_lock(&s_lock);
+#endif // _WIN32
+}
+
+static void unlock_queue(void)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(&s_lock);
+#else
+    pthread_mutex_unlock(&s_lock);
+#endif // _WIN32
+}
+
+static void wait_queue(void)
+{
+#ifdef _WIN32
+    SleepConditionVariableCS(&s_ready, &s_lock, INFINITE);
+#else
+    pthread_cond_wait(&s_ready, &s_lock);
+#endif // _WIN32
+}
+
+static void signal_queue(void)
+{
+#ifdef _WIN32
+    WakeConditionVariable(&s_ready);
+#else
+    pthread_cond_signal(&s_ready);
+#endif // _WIN32
+}
\ No newline at end of file
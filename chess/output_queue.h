@@ -0,0 +1,15 @@
+#ifndef OUTPUT_QUEUE_H
+#define OUTPUT_QUEUE_H
+
+#include <stdio.h>
+
+#include "common_defines.h"
+
+// large enough for a whole iteration with a line for every legal move
+#define OUTPUT_QUEUE_SIZE (1 << 18)
+
+int start_output_queue(FILE* stream);
+void push_output(const char* text);
+void stop_output_queue(void);
+
+#endif // OUTPUT_QUEUE_H
\ No newline at end of file
@@ -3,22 +3,46 @@
 #include <stdlib.h>
 
 #include "piece.h"
+#include "attack_map.h"
 #include "board.h"
-#include "node.h"
+#include "move.h"
+#include "piece_list.h"
 #include "validations.h"
 
-static node_t* get_unchecked_movable_list_or_null(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y);
-static node_t* get_unchecked_movable_list_or_null_king(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y);
-static node_t* get_unchecked_movable_list_or_null_queen(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y);
-static node_t* get_unchecked_movable_list_or_null_rook(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y);
-static node_t* get_unchecked_movable_list_or_null_bishop(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y);
-static node_t* get_unchecked_movable_list_or_null_knight(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y);
-static node_t* get_unchecked_movable_list_or_null_pawn(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y);
-
-static void add_coord(const piece_t board[][BOARD_WIDTH], const color_t team,
-    const size_t dest_x, const size_t dest_y, node_t** plist);
-static void add_coord_recursion(const piece_t board[][BOARD_WIDTH], const color_t team,
-    const size_t dest_x, const size_t dest_y, const int dx, const int dy, node_t** plist);
+typedef enum gen_type {
+    GEN_TYPE_CAPTURES   = (1 << 0),
+    GEN_TYPE_QUIETS     = (1 << 1),
+    GEN_TYPE_ALL        = (GEN_TYPE_CAPTURES | GEN_TYPE_QUIETS)
+} gen_type_t;
+
+static void get_unchecked_list(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist);
+static void get_unchecked_list_king(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist);
+static void get_unchecked_list_rook(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist);
+static void get_unchecked_list_bishop(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist);
+static void get_unchecked_list_knight(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist);
+static void get_unchecked_list_pawn(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist);
+
+static void add_coord(const piece_t board[], const square_t src, const size_t dest_x, const size_t dest_y,
+    const gen_type_t gen_type, move_list_t* plist);
+static void add_coord_recursion(const piece_t board[], const square_t src, const size_t dest_x, const size_t dest_y,
+    const int dx, const int dy, const gen_type_t gen_type, move_list_t* plist);
+static int find_attacker(const piece_t board[], const square_t square,
+    const int offsets[][2], const size_t offset_count, const int b_slide, const piece_t attacker,
+    square_t* out_square);
+static int is_aligned(const square_t a, const square_t b);
+
+const int g_king_offsets[KING_OFFSET_COUNT][2] = {
+    { -1, -1 }, { 0, -1 }, { 1, -1 }, { -1, 0 }, { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 }
+};
+const int g_knight_offsets[KNIGHT_OFFSET_COUNT][2] = {
+    { -2, -1 }, { -1, -2 }, { 2, -1 }, { 1, -2 }, { -2, 1 }, { -1, 2 }, { 2, 1 }, { 1, 2 }
+};
+const int g_bishop_offsets[BISHOP_OFFSET_COUNT][2] = {
+    { -1, -1 }, { 1, 1 }, { 1, -1 }, { -1, 1 }
+};
+const int g_rook_offsets[ROOK_OFFSET_COUNT][2] = {
+    { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 }
+};
 
 color_t get_color(const piece_t piece)
 {
@@ -35,282 +59,322 @@ int is_first_move(const piece_t piece)
     return !(piece & MOVE_FLAG);
 }
 
-node_t* get_movable_list_or_null(const piece_t board[][BOARD_WIDTH], const char* coord)
+size_t get_shape_index(const shape_t shape)
 {
-    assert(board != NULL);
-    assert(coord != NULL);
-    assert(is_valid_coord(coord));
+    switch (shape) {
+    case SHAPE_PAWN:
+        return 0;
+    case SHAPE_KNIGHT:
+        return 1;
+    case SHAPE_BISHOP:
+        return 2;
+    case SHAPE_ROOK:
+        return 3;
+    case SHAPE_QUEEN:
+        return 4;
+    case SHAPE_KING:
+        return 5;
+    default:
+        assert(FALSE && "invalid shape");
+        return 0;
+    }
+}
+
+size_t get_color_index(const color_t color)
+{
+    assert(color == COLOR_WHITE || color == COLOR_BLACK);
+
+    return (color == COLOR_WHITE) ? 0 : 1;
+}
 
-    size_t src_x = translate_to_board_x(coord);
-    size_t src_y = translate_to_board_y(coord);
+void get_movable_list(const piece_t board[], const struct piece_list* piece_list,
+    const struct attack_map* attack_map, const square_t src, move_list_t* out_movable_list)
+{
+    assert(board != NULL);
+    assert(piece_list != NULL);
+    assert(attack_map != NULL);
+    assert(src < SQUARE_COUNT);
+    assert(out_movable_list != NULL);
 
-    piece_t piece = board[src_y][src_x];
+    piece_t piece = board[src];
     color_t color = get_color(piece);
-    node_t* movable_list = get_unchecked_movable_list_or_null(board, src_x, src_y);
+    color_t other_color = (color == COLOR_WHITE) ? COLOR_BLACK : COLOR_WHITE;
+
+    out_movable_list->count = 0;
+    get_unchecked_list(board, src, GEN_TYPE_ALL, out_movable_list);
+
+    square_t king_square = piece_list->king_squares[get_color_index(color)];
+
+    int b_king = (get_shape(piece) == SHAPE_KING);
+    int b_in_check = is_attacked(attack_map, king_square, other_color);
+
+    // out of check, a king only has to stay off attacked squares
+    // and a piece off the king's lines cannot be pinned
+    if (!b_in_check && !b_king && !is_aligned(src, king_square)) {
+        return;
+    }
 
     // copy board
-    piece_t copied_board[BOARD_HEIGHT][BOARD_WIDTH];
-    memcpy(copied_board, board, BOARD_WIDTH * BOARD_HEIGHT * sizeof(piece_t));
+    piece_t copied_board[SQUARE_COUNT];
+    memcpy(copied_board, board, SQUARE_COUNT * sizeof(piece_t));
 
     // remove illegal moves
-    node_t* p = movable_list;
-    while (p != NULL) {
-        piece_t origin_piece = copied_board[p->y][p->x];
-        copied_board[p->y][p->x] = piece;
-        copied_board[src_y][src_x] = 0;
-
-        node_t* deleted_node = NULL;
-
-        for (size_t y = 0; y < BOARD_HEIGHT; ++y) {
-            for (size_t x = 0; x < BOARD_WIDTH; ++x) {
-                if (get_color(copied_board[y][x]) != color) {
-                    node_t* other_movable_list = get_unchecked_movable_list_or_null(copied_board, x, y);
-                    node_t* q = other_movable_list;
-                    while (q != NULL) {
-                        piece_t other_piece = copied_board[q->y][q->x];
-                        shape_t other_shape = get_shape(other_piece);
-                        color_t other_color = get_color(other_piece);
-
-                        if (other_shape == SHAPE_KING && other_color == color) {
-                            deleted_node = p;
-                            goto deleted;
-                        }
-
-                        q = q->next;
-                    }
-
-                    destroy_list(other_movable_list);
-                }
-            }
+    size_t legal_count = 0;
+    for (size_t i = 0; i < out_movable_list->count; ++i) {
+        move_t move = out_movable_list->moves[i];
+        square_t dest = get_move_dest(move);
+        int b_exposed;
+
+        if (!b_in_check && b_king) {
+            b_exposed = is_attacked(attack_map, dest, other_color);
         }
+        else {
+            piece_t origin_piece = copied_board[dest];
+            copied_board[dest] = piece;
+            copied_board[src] = 0;
 
-    deleted:
-        copied_board[src_y][src_x] = piece;
-        copied_board[p->y][p->x] = origin_piece;
+            b_exposed = is_square_attacked(copied_board, b_king ? dest : king_square, other_color);
 
-        p = p->next;
+            copied_board[src] = piece;
+            copied_board[dest] = origin_piece;
+        }
 
-        delete_node(&movable_list, deleted_node);
+        if (!b_exposed) {
+            out_movable_list->moves[legal_count++] = move;
+        }
     }
-
-    return movable_list;
+    out_movable_list->count = legal_count;
 }
 
-static node_t* get_unchecked_movable_list_or_null(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y)
+void get_unchecked_capture_list(const piece_t board[], const square_t src, move_list_t* out_capture_list)
 {
-    piece_t piece = board[y][x];
-    color_t color = get_color(piece);
-    node_t* movable_list = NULL;
-
-    switch (get_shape(piece)) {
-    case SHAPE_KING:
-        movable_list = get_unchecked_movable_list_or_null_king(board, x, y);
-        break;
-    case SHAPE_QUEEN:
-        movable_list = get_unchecked_movable_list_or_null_queen(board, x, y);
-        break;
-    case SHAPE_ROOK:
-        movable_list = get_unchecked_movable_list_or_null_rook(board, x, y);
-        break;
-    case SHAPE_BISHOP:
-        movable_list = get_unchecked_movable_list_or_null_bishop(board, x, y);
-        break;
-    case SHAPE_KNIGHT:
-        movable_list = get_unchecked_movable_list_or_null_knight(board, x, y);
-        break;
-    case SHAPE_PAWN:
-        movable_list = get_unchecked_movable_list_or_null_pawn(board, x, y);
-        break;
-    default:
-        movable_list = NULL;
-        break;
-    }
+    get_unchecked_list(board, src, GEN_TYPE_CAPTURES, out_capture_list);
+}
 
-    return movable_list;
+void get_unchecked_quiet_list(const piece_t board[], const square_t src, move_list_t* out_quiet_list)
+{
+    get_unchecked_list(board, src, GEN_TYPE_QUIETS, out_quiet_list);
 }
 
-static node_t* get_unchecked_movable_list_or_null_king(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y)
+int find_least_valuable_attacker(const piece_t board[], const square_t square,
+    const color_t attacker_color, square_t* out_square)
 {
     assert(board != NULL);
-    assert(is_valid_xy(x, y));
-
-    piece_t piece = board[y][x];
-    piece_t piece_shape = get_shape(piece);
-    piece_t piece_color = get_color(piece);
-
-    assert(piece_shape == SHAPE_KING);
+    assert(square < SQUARE_COUNT);
+    assert(out_square != NULL);
+
+    // a pawn attacks the square one rank ahead of it, so look one rank behind from its point of view
+    const int pawn_direction = (attacker_color == COLOR_WHITE) ? 1 : -1;
+    const int pawn_offsets[2][2] = { { -1, pawn_direction }, { 1, pawn_direction } };
+
+    return find_attacker(board, square, pawn_offsets, 2, FALSE, SHAPE_PAWN | attacker_color, out_square)
+        || find_attacker(board, square, g_knight_offsets, KNIGHT_OFFSET_COUNT, FALSE, SHAPE_KNIGHT | attacker_color, out_square)
+        || find_attacker(board, square, g_bishop_offsets, BISHOP_OFFSET_COUNT, TRUE, SHAPE_BISHOP | attacker_color, out_square)
+        || find_attacker(board, square, g_rook_offsets, ROOK_OFFSET_COUNT, TRUE, SHAPE_ROOK | attacker_color, out_square)
+        || find_attacker(board, square, g_bishop_offsets, BISHOP_OFFSET_COUNT, TRUE, SHAPE_QUEEN | attacker_color, out_square)
+        || find_attacker(board, square, g_rook_offsets, ROOK_OFFSET_COUNT, TRUE, SHAPE_QUEEN | attacker_color, out_square)
+        || find_attacker(board, square, g_king_offsets, KING_OFFSET_COUNT, FALSE, SHAPE_KING | attacker_color, out_square);
+}
 
-    node_t* movable_list = NULL;
-    add_coord(board, piece_color, x - 1, y - 1, &movable_list);   // left-forward
-    add_coord(board, piece_color, x, y - 1, &movable_list);       // forward
-    add_coord(board, piece_color, x + 1, y - 1, &movable_list);   // right-forward
-    add_coord(board, piece_color, x - 1, y, &movable_list);       // left
-    add_coord(board, piece_color, x + 1, y, &movable_list);       // right
-    add_coord(board, piece_color, x - 1, y + 1, &movable_list);   // left-backward
-    add_coord(board, piece_color, x, y + 1, &movable_list);       // backward
-    add_coord(board, piece_color, x + 1, y + 1, &movable_list);   // right-backward
+int is_square_attacked(const piece_t board[], const square_t square, const color_t attacker_color)
+{
+    square_t attacker_square;
 
-    return movable_list;
+    return find_least_valuable_attacker(board, square, attacker_color, &attacker_square);
 }
 
-static node_t* get_unchecked_movable_list_or_null_queen(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y)
+// the squares one step, or a whole ray, away from x, y in the direction of the offset,
+// up to and including the first occupied one. returns how many there are
+size_t get_ray_squares(const piece_t board[], const size_t x, const size_t y, const int offset[2], const int b_slide,
+    square_t out_squares[])
 {
     assert(board != NULL);
-    assert(is_valid_xy(x, y));
-
-    piece_t piece = board[y][x];
-    piece_t piece_shape = get_shape(piece);
-    piece_t piece_color = get_color(piece);
+    assert(offset != NULL);
+    assert(out_squares != NULL);
 
-    assert(piece_shape == SHAPE_QUEEN);
+    size_t count = 0;
+    size_t dest_x = x + offset[0];
+    size_t dest_y = y + offset[1];
 
-    node_t* movable_list_queen = NULL;
-    node_t* movable_list_rook = get_unchecked_movable_list_or_null_rook(board, x, y);
-    node_t* movable_list_bishop = get_unchecked_movable_list_or_null_bishop(board, x, y);
+    while (is_valid_xy(dest_x, dest_y)) {
+        square_t dest = to_square(dest_x, dest_y);
+        out_squares[count++] = dest;
 
-    // merge
-    if (movable_list_rook != NULL && movable_list_bishop != NULL) {
-        node_t* p = movable_list_rook;
-        while (p->next != NULL) {
-            p = p->next;
+        if (!b_slide || board[dest] != 0) {
+            break;
         }
-        p->next = movable_list_bishop;
 
-        movable_list_queen = movable_list_rook;
-    }
-    else if (movable_list_rook != NULL) {
-        movable_list_queen = movable_list_rook;
-    }
-    else if (movable_list_bishop != NULL) {
-        movable_list_queen = movable_list_bishop;
+        dest_x += offset[0];
+        dest_y += offset[1];
     }
 
-    return movable_list_queen;
+    return count;
 }
 
-static node_t* get_unchecked_movable_list_or_null_rook(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y)
+static void get_unchecked_list(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist)
 {
     assert(board != NULL);
-    assert(is_valid_xy(x, y));
-
-    piece_t piece = board[y][x];
-    piece_t piece_shape = get_shape(piece);
-    piece_t piece_color = get_color(piece);
-
-    assert((piece_shape & SHAPE_ROOK) == SHAPE_ROOK);
-
-    node_t* movable_list = NULL;
-    add_coord_recursion(board, piece_color, x, y - 1, 0, -1, &movable_list); // forward
-    add_coord_recursion(board, piece_color, x, y + 1, 0, 1, &movable_list); // backward
-    add_coord_recursion(board, piece_color, x - 1, y, -1, 0, &movable_list); // left
-    add_coord_recursion(board, piece_color, x + 1, y, 1, 0, &movable_list); // right
+    assert(src < SQUARE_COUNT);
+    assert(plist != NULL);
 
-    return movable_list;
+    switch (get_shape(board[src])) {
+    case SHAPE_KING:
+        get_unchecked_list_king(board, src, gen_type, plist);
+        break;
+    case SHAPE_QUEEN:
+        get_unchecked_list_rook(board, src, gen_type, plist);
+        get_unchecked_list_bishop(board, src, gen_type, plist);
+        break;
+    case SHAPE_ROOK:
+        get_unchecked_list_rook(board, src, gen_type, plist);
+        break;
+    case SHAPE_BISHOP:
+        get_unchecked_list_bishop(board, src, gen_type, plist);
+        break;
+    case SHAPE_KNIGHT:
+        get_unchecked_list_knight(board, src, gen_type, plist);
+        break;
+    case SHAPE_PAWN:
+        get_unchecked_list_pawn(board, src, gen_type, plist);
+        break;
+    default:
+        break;
+    }
 }
 
-static node_t* get_unchecked_movable_list_or_null_bishop(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y)
+static void get_unchecked_list_king(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist)
 {
-    assert(board != NULL);
-    assert(is_valid_xy(x, y));
-
-    piece_t piece = board[y][x];
-    piece_t piece_shape = get_shape(piece);
-    piece_t piece_color = get_color(piece);
+    assert(get_shape(board[src]) == SHAPE_KING);
+
+    size_t x = get_square_x(src);
+    size_t y = get_square_y(src);
+
+    add_coord(board, src, x - 1, y - 1, gen_type, plist);   // left-forward
+    add_coord(board, src, x, y - 1, gen_type, plist);       // forward
+    add_coord(board, src, x + 1, y - 1, gen_type, plist);   // right-forward
+    add_coord(board, src, x - 1, y, gen_type, plist);       // left
+    add_coord(board, src, x + 1, y, gen_type, plist);       // right
+    add_coord(board, src, x - 1, y + 1, gen_type, plist);   // left-backward
+    add_coord(board, src, x, y + 1, gen_type, plist);       // backward
+    add_coord(board, src, x + 1, y + 1, gen_type, plist);   // right-backward
+}
 
-    assert((piece_shape & SHAPE_BISHOP) == SHAPE_BISHOP);
+static void get_unchecked_list_rook(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist)
+{
+    assert((get_shape(board[src]) & SHAPE_ROOK) == SHAPE_ROOK);
 
-    node_t* movable_list = NULL;
-    add_coord_recursion(board, piece_color, x - 1, y - 1, -1, -1, &movable_list); // left-forward
-    add_coord_recursion(board, piece_color, x + 1, y + 1, 1, 1, &movable_list); // right-backward
-    add_coord_recursion(board, piece_color, x + 1, y - 1, 1, -1, &movable_list); // right-forward
-    add_coord_recursion(board, piece_color, x - 1, y + 1, -1, 1, &movable_list); // left-backward
+    size_t x = get_square_x(src);
+    size_t y = get_square_y(src);
 
-    return movable_list;
+    add_coord_recursion(board, src, x, y - 1, 0, -1, gen_type, plist); // forward
+    add_coord_recursion(board, src, x, y + 1, 0, 1, gen_type, plist); // backward
+    add_coord_recursion(board, src, x - 1, y, -1, 0, gen_type, plist); // left
+    add_coord_recursion(board, src, x + 1, y, 1, 0, gen_type, plist); // right
 }
 
-static node_t* get_unchecked_movable_list_or_null_knight(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y)
+static void get_unchecked_list_bishop(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist)
 {
-    assert(board != NULL);
-    assert(is_valid_xy(x, y));
-
-    piece_t piece = board[y][x];
-    piece_t piece_shape = get_shape(piece);
-    piece_t piece_color = get_color(piece);
-
-    assert(piece_shape == SHAPE_KNIGHT);
+    assert((get_shape(board[src]) & SHAPE_BISHOP) == SHAPE_BISHOP);
 
-    node_t* movable_list = NULL;
-    add_coord(board, piece_color, x - 2, y - 1, &movable_list); // left-forward1
-    add_coord(board, piece_color, x - 1, y - 2, &movable_list); // left-forward2
-    add_coord(board, piece_color, x + 2, y - 1, &movable_list); // right-forward1
-    add_coord(board, piece_color, x + 1, y - 2, &movable_list); // right-forward2
-    add_coord(board, piece_color, x - 2, y + 1, &movable_list); // left-backwoard1
-    add_coord(board, piece_color, x - 1, y + 2, &movable_list); // left-backwoard2
-    add_coord(board, piece_color, x + 2, y + 1, &movable_list); // right-backwoard1
-    add_coord(board, piece_color, x + 1, y + 2, &movable_list); // right-backwoard2
+    size_t x = get_square_x(src);
+    size_t y = get_square_y(src);
 
-    return movable_list;
+    add_coord_recursion(board, src, x - 1, y - 1, -1, -1, gen_type, plist); // left-forward
+    add_coord_recursion(board, src, x + 1, y + 1, 1, 1, gen_type, plist); // right-backward
+    add_coord_recursion(board, src, x + 1, y - 1, 1, -1, gen_type, plist); // right-forward
+    add_coord_recursion(board, src, x - 1, y + 1, -1, 1, gen_type, plist); // left-backward
 }
 
-static node_t* get_unchecked_movable_list_or_null_pawn(const piece_t board[][BOARD_WIDTH], const size_t x, const size_t y)
+static void get_unchecked_list_knight(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist)
 {
-    assert(board != NULL);
-    assert(is_valid_xy(x, y));
+    assert(get_shape(board[src]) == SHAPE_KNIGHT);
+
+    size_t x = get_square_x(src);
+    size_t y = get_square_y(src);
+
+    add_coord(board, src, x - 2, y - 1, gen_type, plist); // left-forward1
+    add_coord(board, src, x - 1, y - 2, gen_type, plist); // left-forward2
+    add_coord(board, src, x + 2, y - 1, gen_type, plist); // right-forward1
+    add_coord(board, src, x + 1, y - 2, gen_type, plist); // right-forward2
+    add_coord(board, src, x - 2, y + 1, gen_type, plist); // left-backwoard1
+    add_coord(board, src, x - 1, y + 2, gen_type, plist); // left-backwoard2
+    add_coord(board, src, x + 2, y + 1, gen_type, plist); // right-backwoard1
+    add_coord(board, src, x + 1, y + 2, gen_type, plist); // right-backwoard2
+}
 
-    piece_t piece = board[y][x];
-    piece_t piece_shape = get_shape(piece);
-    piece_t piece_color = get_color(piece);
+static void get_unchecked_list_pawn(const piece_t board[], const square_t src, const gen_type_t gen_type, move_list_t* plist)
+{
+    piece_t piece = board[src];
+    color_t piece_color = get_color(piece);
 
-    assert(piece_shape == SHAPE_PAWN);
+    assert(get_shape(piece) == SHAPE_PAWN);
 
     int direction = (piece_color == COLOR_WHITE) ? -1 : 1;
 
+    size_t x = get_square_x(src);
+    size_t y = get_square_y(src);
     size_t forward_y = y + direction;
     size_t forward2_y = forward_y + direction;
     size_t top_left_x = x - 1;
     size_t top_right_x = x + 1;
 
-    node_t* movable_list = NULL;
+    if (gen_type & GEN_TYPE_QUIETS) {
+        // forward1
+        if (is_valid_xy(x, forward_y) && board[to_square(x, forward_y)] == 0) {
+            add_move(plist, encode_move(src, to_square(x, forward_y), 0));
 
-    // forward1 
-    if (is_valid_xy(x, forward_y) && board[forward_y][x] == 0) {
-        insert_front(&movable_list, x, forward_y);
-    }
-
-    // forward2 
-    if (is_valid_xy(x, forward2_y) && is_first_move(piece) && board[forward2_y][x] == 0) {
-        insert_front(&movable_list, x, forward2_y);
+            // forward2, only over an empty square
+            if (is_valid_xy(x, forward2_y) && is_first_move(piece) && board[to_square(x, forward2_y)] == 0) {
+                add_move(plist, encode_move(src, to_square(x, forward2_y), 0));
+            }
+        }
     }
 
-    // left-forward 
-    color_t top_left_color = get_color(board[forward_y][top_left_x]);
-    if (is_valid_xy(top_left_x, forward_y) && top_left_color != 0 && top_left_color != piece_color) {
-        insert_front(&movable_list, top_left_x, forward_y);
-    }
+    if (gen_type & GEN_TYPE_CAPTURES) {
+        // left-forward
+        if (is_valid_xy(top_left_x, forward_y)) {
+            color_t top_left_color = get_color(board[to_square(top_left_x, forward_y)]);
+            if (top_left_color != 0 && top_left_color != piece_color) {
+                add_move(plist, encode_move(src, to_square(top_left_x, forward_y), MOVE_KIND_CAPTURE));
+            }
+        }
 
-    // right-forward
-    color_t top_right_color = get_color(board[forward_y][top_right_x]);
-    if (is_valid_xy(top_right_x, forward_y) && top_right_color != 0 && top_right_color != piece_color) {
-        insert_front(&movable_list, top_right_x, forward_y);
+        // right-forward
+        if (is_valid_xy(top_right_x, forward_y)) {
+            color_t top_right_color = get_color(board[to_square(top_right_x, forward_y)]);
+            if (top_right_color != 0 && top_right_color != piece_color) {
+                add_move(plist, encode_move(src, to_square(top_right_x, forward_y), MOVE_KIND_CAPTURE));
+            }
+        }
     }
-
-    return movable_list;
 }
 
-static void add_coord(const piece_t board[][BOARD_WIDTH], const color_t team,
-    const size_t dest_x, const size_t dest_y, node_t** plist)
+static void add_coord(const piece_t board[], const square_t src, const size_t dest_x, const size_t dest_y,
+    const gen_type_t gen_type, move_list_t* plist)
 {
     assert(board != NULL);
     assert(plist != NULL);
 
-    piece_t piece = board[dest_y][dest_x];
-    if (is_valid_xy(dest_x, dest_y) && get_color(piece) != team) {
-        insert_front(plist, dest_x, dest_y);
+    if (!is_valid_xy(dest_x, dest_y)) {
+        return;
+    }
+
+    square_t dest = to_square(dest_x, dest_y);
+    color_t color = get_color(board[dest]);
+    if (color == 0) {
+        if (gen_type & GEN_TYPE_QUIETS) {
+            add_move(plist, encode_move(src, dest, 0));
+        }
+    }
+    else if (color != get_color(board[src])) {
+        if (gen_type & GEN_TYPE_CAPTURES) {
+            add_move(plist, encode_move(src, dest, MOVE_KIND_CAPTURE));
+        }
     }
 }
 
-static void add_coord_recursion(const piece_t board[][BOARD_WIDTH], const color_t team,
-    const size_t dest_x, const size_t dest_y, const int dx, const int dy, node_t** plist)
+static void add_coord_recursion(const piece_t board[], const square_t src, const size_t dest_x, const size_t dest_y,
+    const int dx, const int dy, const gen_type_t gen_type, move_list_t* plist)
 {
     assert(board != NULL);
     assert(plist != NULL);
@@ -319,13 +383,58 @@ static void add_coord_recursion(const piece_t board[][BOARD_WIDTH], const color_
         return;
     }
 
-    piece_t piece = board[dest_y][dest_x];
-    color_t color = get_color(piece);
+    square_t dest = to_square(dest_x, dest_y);
+    color_t color = get_color(board[dest]);
     if (color == 0) {
-        insert_front(plist, dest_x, dest_y);
-        add_coord_recursion(board, team, dest_x + dx, dest_y + dy, dx, dy, plist);
+        if (gen_type & GEN_TYPE_QUIETS) {
+            add_move(plist, encode_move(src, dest, 0));
+        }
+        add_coord_recursion(board, src, dest_x + dx, dest_y + dy, dx, dy, gen_type, plist);
     }
-    else if (color != team) {
-        insert_front(plist, dest_x, dest_y);
+    else if (color != get_color(board[src])) {
+        if (gen_type & GEN_TYPE_CAPTURES) {
+            add_move(plist, encode_move(src, dest, MOVE_KIND_CAPTURE));
+        }
     }
+}
+
+static int find_attacker(const piece_t board[], const square_t square,
+    const int offsets[][2], const size_t offset_count, const int b_slide, const piece_t attacker,
+    square_t* out_square)
+{
+    assert(board != NULL);
+    assert(offsets != NULL);
+
+    size_t x = get_square_x(square);
+    size_t y = get_square_y(square);
+
+    // only the last square of a ray can hold a piece
+    for (size_t i = 0; i < offset_count; ++i) {
+        square_t ray[MAX_RAY_LENGTH];
+        size_t ray_length = get_ray_squares(board, x, y, offsets[i], b_slide, ray);
+        if (ray_length == 0) {
+            continue;
+        }
+
+        square_t src = ray[ray_length - 1];
+        if ((board[src] & ~MOVE_FLAG) == attacker) {
+            *out_square = src;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static int is_aligned(const square_t a, const square_t b)
+{
+    size_t ax = get_square_x(a);
+    size_t ay = get_square_y(a);
+    size_t bx = get_square_x(b);
+    size_t by = get_square_y(b);
+
+    size_t dx = (ax > bx) ? ax - bx : bx - ax;
+    size_t dy = (ay > by) ? ay - by : by - ay;
+
+    return (dx == 0 || dy == 0 || dx == dy);
 }
\ No newline at end of file
@@ -2,12 +2,22 @@
 #define PIECE_H
 
 #include "common_defines.h"
-#include "node.h"
+#include "move.h"
 
 #define COLOR_FLAG (0xc0)
 #define SHAPE_FLAG (0x3e)
 #define MOVE_FLAG (0x1)
 
+#define SHAPE_COUNT (6)
+#define COLOR_COUNT (2)
+
+#define KING_OFFSET_COUNT (8)
+#define KNIGHT_OFFSET_COUNT (8)
+#define BISHOP_OFFSET_COUNT (4)
+#define ROOK_OFFSET_COUNT (4)
+
+#define MAX_RAY_LENGTH (BOARD_WIDTH - 1)
+
 typedef unsigned char piece_t;
 
 typedef enum shape {
@@ -19,15 +29,36 @@ typedef enum shape {
 	SHAPE_KING      = (1 << 5)
 } shape_t;
 
+struct piece_list;
+struct attack_map;
+
 typedef enum color {
 	COLOR_BLACK = (1 << 6),
 	COLOR_WHITE = (1 << 7)
 } color_t;
 
+// { dx, dy } steps of each shape
+extern const int g_king_offsets[KING_OFFSET_COUNT][2];
+extern const int g_knight_offsets[KNIGHT_OFFSET_COUNT][2];
+extern const int g_bishop_offsets[BISHOP_OFFSET_COUNT][2];
+extern const int g_rook_offsets[ROOK_OFFSET_COUNT][2];
+
 color_t get_color(const piece_t piece);
 shape_t get_shape(const piece_t piece);
 int is_first_move(const piece_t piece);
+size_t get_shape_index(const shape_t shape);
+size_t get_color_index(const color_t color);
+
+void get_movable_list(const piece_t board[], const struct piece_list* piece_list,
+    const struct attack_map* attack_map, const square_t src, move_list_t* out_movable_list);
+void get_unchecked_capture_list(const piece_t board[], const square_t src, move_list_t* out_capture_list);
+void get_unchecked_quiet_list(const piece_t board[], const square_t src, move_list_t* out_quiet_list);
+
+int find_least_valuable_attacker(const piece_t board[], const square_t square,
+    const color_t attacker_color, square_t* out_square);
+int is_square_attacked(const piece_t board[], const square_t square, const color_t attacker_color);
 
-node_t* get_movable_list_or_null(const piece_t board[][BOARD_WIDTH], const char* coord);
+size_t get_ray_squares(const piece_t board[], const size_t x, const size_t y, const int offset[2], const int b_slide,
+    square_t out_squares[]);
 
 #endif // PIECE_H
\ No newline at end of file
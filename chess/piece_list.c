@@ -0,0 +1,59 @@
+#include <assert.h>
+#include <stddef.h>
+
+#include "piece_list.h"
+
+void init_piece_list(piece_list_t* piece_list, const piece_t board[])
+{
+    assert(piece_list != NULL);
+    assert(board != NULL);
+
+    for (size_t i = 0; i < COLOR_COUNT; ++i) {
+        piece_list->counts[i] = 0;
+        piece_list->king_squares[i] = 0;
+    }
+
+    for (size_t square = 0; square < SQUARE_COUNT; ++square) {
+        if (board[square] != 0) {
+            add_to_piece_list(piece_list, board[square], (square_t)square);
+        }
+    }
+}
+
+void add_to_piece_list(piece_list_t* piece_list, const piece_t piece, const square_t square)
+{
+    assert(piece_list != NULL);
+    assert(square < SQUARE_COUNT);
+
+    size_t color_index = get_color_index(get_color(piece));
+    size_t count = piece_list->counts[color_index];
+
+    assert(count < MAX_PIECE_COUNT);
+
+    piece_list->squares[color_index][count] = square;
+    piece_list->indices[square] = (unsigned char)count;
+    piece_list->counts[color_index] = count + 1;
+
+    if (get_shape(piece) == SHAPE_KING) {
+        piece_list->king_squares[color_index] = square;
+    }
+}
+
+// the last square takes the place of the removed one, so the order of a list is not stable
+void remove_from_piece_list(piece_list_t* piece_list, const piece_t piece, const square_t square)
+{
+    assert(piece_list != NULL);
+    assert(square < SQUARE_COUNT);
+
+    size_t color_index = get_color_index(get_color(piece));
+    size_t index = piece_list->indices[square];
+    size_t last_index = piece_list->counts[color_index] - 1;
+
+    assert(piece_list->counts[color_index] > 0);
+    assert(piece_list->squares[color_index][index] == square);
+
+    square_t last_square = piece_list->squares[color_index][last_index];
+    piece_list->squares[color_index][index] = last_square;
+    piece_list->indices[last_square] = (unsigned char)index;
+    piece_list->counts[color_index] = last_index;
+}
\ No newline at end of file
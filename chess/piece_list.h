@@ -0,0 +1,20 @@
+#ifndef PIECE_LIST_H
+#define PIECE_LIST_H
+
+#include "common_defines.h"
+#include "piece.h"
+
+#define MAX_PIECE_COUNT (16)
+
+typedef struct piece_list {
+	square_t squares[COLOR_COUNT][MAX_PIECE_COUNT];
+	size_t counts[COLOR_COUNT];
+	unsigned char indices[SQUARE_COUNT];
+	square_t king_squares[COLOR_COUNT];
+} piece_list_t;
+
+void init_piece_list(piece_list_t* piece_list, const piece_t board[]);
+void add_to_piece_list(piece_list_t* piece_list, const piece_t piece, const square_t square);
+void remove_from_piece_list(piece_list_t* piece_list, const piece_t piece, const square_t square);
+
+#endif // PIECE_LIST_H
\ No newline at end of file
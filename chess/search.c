@@ -0,0 +1,458 @@
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "search.h"
+#include "analysis_cache.h"
+#include "board.h"
+#include "move_picker.h"
+
+#define MAX_HISTORY_SCORE (1 << 20)
+
+static unsigned long long s_node_count;
+
+static move_t s_killers[MAX_PLY][KILLER_COUNT];
+static int s_history[COLOR_COUNT][SQUARE_COUNT][SQUARE_COUNT];
+
+// triangular principal variation table, and the line of the previous iteration
+static move_t s_pv_table[MAX_PLY][MAX_PLY];
+static size_t s_pv_lengths[MAX_PLY];
+static move_t s_prev_pv[MAX_PLY];
+static size_t s_prev_pv_length;
+
+// every legal root move with its line, for searching more than one line
+static search_line_t s_root_lines[MAX_MOVES];
+static size_t s_root_line_count;
+
+// reported lines are searched out to their depth, a cached exact score only cuts off outside the window
+static int s_b_searching_lines;
+
+static void start_search(void);
+static void generate_root_lines(void);
+static void search_root(const size_t depth, const size_t line_count);
+static void insert_root_line(const size_t index);
+static int move_root_line_to_front(const move_t move);
+
+static int search_node(const size_t depth, const size_t ply, int alpha, const int beta, const int b_follow_pv);
+static int search_captures(const size_t ply, int alpha, const int beta);
+static void update_quiet_heuristics(const move_t move, const size_t depth, const size_t ply);
+static void age_history(void);
+static int is_legal_move(const move_t move);
+static int get_cache_score(const int score, const size_t ply);
+static int get_search_score(const int cache_score, const size_t ply);
+
+void search(const size_t max_depth, search_result_t* out_result)
+{
+    assert(max_depth > 0 && max_depth < MAX_PLY);
+    assert(out_result != NULL);
+
+    start_search();
+    s_b_searching_lines = FALSE;
+
+    out_result->b_has_best_move = FALSE;
+    out_result->score = 0;
+    out_result->depth = 0;
+
+    // a warm restart takes the cached result for the position and goes on from the depth it reached
+    size_t start_depth = 1;
+    cached_analysis_t cached;
+    if (probe_analysis_cache(get_hash(), &cached) && cached.bound == CACHE_BOUND_EXACT
+        && cached.depth > 0 && is_legal_move(cached.best_move)) {
+        out_result->best_move = cached.best_move;
+        out_result->b_has_best_move = TRUE;
+        out_result->score = cached.score;
+        out_result->depth = cached.depth;
+
+        s_prev_pv[0] = cached.best_move;
+        s_prev_pv_length = 1;
+        start_depth = cached.depth + 1;
+    }
+
+    for (size_t depth = start_depth; depth <= max_depth; ++depth) {
+        int score = search_node(depth, 0, -INFINITE_SCORE, INFINITE_SCORE, TRUE);
+
+        s_prev_pv_length = s_pv_lengths[0];
+        memcpy(s_prev_pv, s_pv_table[0], s_prev_pv_length * sizeof(move_t));
+
+        out_result->score = score;
+        out_result->depth = depth;
+        if (s_prev_pv_length > 0) {
+            out_result->best_move = s_prev_pv[0];
+            out_result->b_has_best_move = TRUE;
+        }
+    }
+
+    out_result->node_count = s_node_count;
+}
+
+// a report goes out after every iteration, so the caller sees each depth as soon as it is done
+void search_lines(const size_t max_depth, const size_t line_count, search_report_func_t report)
+{
+    assert(max_depth > 0 && max_depth < MAX_PLY);
+    assert(line_count > 0);
+    assert(report != NULL);
+
+    start_search();
+    s_b_searching_lines = TRUE;
+    generate_root_lines();
+
+    // a warm restart searches the cached best move first and skips the depths the cache already has,
+    // the last depth is always searched so that every requested line is reported
+    size_t start_depth = 1;
+    cached_analysis_t cached;
+    if (probe_analysis_cache(get_hash(), &cached) && cached.bound == CACHE_BOUND_EXACT
+        && cached.depth > 0 && move_root_line_to_front(cached.best_move)) {
+        s_prev_pv[0] = cached.best_move;
+        s_prev_pv_length = 1;
+        start_depth = (cached.depth < max_depth) ? cached.depth + 1 : max_depth;
+    }
+
+    search_report_t search_report;
+    search_report.lines = s_root_lines;
+    search_report.line_count = (line_count < s_root_line_count) ? line_count : s_root_line_count;
+
+    for (size_t depth = start_depth; depth <= max_depth && s_root_line_count > 0; ++depth) {
+        search_root(depth, search_report.line_count);
+
+        search_report.depth = depth;
+        search_report.node_count = s_node_count;
+        report(&search_report);
+    }
+}
+
+static void start_search(void)
+{
+    memset(s_killers, 0, sizeof(s_killers));
+    age_history();
+
+    s_node_count = 0;
+    s_prev_pv_length = 0;
+}
+
+static void generate_root_lines(void)
+{
+    const color_t TURN = get_turn();
+
+    move_picker_t picker;
+    init_move_picker(&picker, get_board(), get_piece_list(), TURN, NULL, NULL, s_history[get_color_index(TURN)]);
+
+    s_root_line_count = 0;
+
+    move_t move;
+    undo_t undo;
+    while (pick_next_move(&picker, &move)) {
+        make_move(move, &undo);
+        if (!is_in_check(TURN)) {
+            search_line_t* line = &s_root_lines[s_root_line_count++];
+            line->moves[0] = move;
+            line->length = 1;
+            line->score = -INFINITE_SCORE;
+        }
+        unmake_move(&undo);
+    }
+}
+
+// the window stays open until the requested number of lines is filled,
+// after that a root move only has to beat the last of them
+static void search_root(const size_t depth, const size_t line_count)
+{
+    ++s_node_count;
+
+    int alpha = -INFINITE_SCORE;
+    undo_t undo;
+
+    // the lines are still in the order of the previous iteration, the best one first
+    for (size_t i = 0; i < s_root_line_count; ++i) {
+        search_line_t* line = &s_root_lines[i];
+
+        make_move(line->moves[0], &undo);
+        int score = -search_node(depth - 1, 1, -INFINITE_SCORE, -alpha, i == 0);
+        unmake_move(&undo);
+
+        line->score = score;
+        if (score > alpha) {
+            memcpy(&line->moves[1], s_pv_table[1], s_pv_lengths[1] * sizeof(move_t));
+            line->length = s_pv_lengths[1] + 1;
+        }
+        else {
+            line->length = 1;
+        }
+
+        insert_root_line(i);
+        if (i + 1 >= line_count) {
+            alpha = s_root_lines[line_count - 1].score;
+        }
+    }
+
+    s_prev_pv_length = s_root_lines[0].length;
+    memcpy(s_prev_pv, s_root_lines[0].moves, s_prev_pv_length * sizeof(move_t));
+
+    // the best line was searched with an open window, so its score is exact
+    cached_analysis_t analysis;
+    analysis.best_move = s_root_lines[0].moves[0];
+    analysis.score = s_root_lines[0].score;
+    analysis.depth = depth;
+    analysis.bound = CACHE_BOUND_EXACT;
+    analysis.legal_move_count = s_root_line_count;
+    store_analysis_cache(get_hash(), &analysis);
+}
+
+// returns FALSE when the move is not a legal root move
+static int move_root_line_to_front(const move_t move)
+{
+    for (size_t i = 0; i < s_root_line_count; ++i) {
+        if (s_root_lines[i].moves[0] == move) {
+            search_line_t line = s_root_lines[i];
+            memmove(&s_root_lines[1], &s_root_lines[0], i * sizeof(search_line_t));
+            s_root_lines[0] = line;
+
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+// moves the line at index up into the sorted lines before it
+static void insert_root_line(const size_t index)
+{
+    search_line_t line = s_root_lines[index];
+
+    size_t i = index;
+    while (i > 0 && s_root_lines[i - 1].score < line.score) {
+        s_root_lines[i] = s_root_lines[i - 1];
+        --i;
+    }
+    s_root_lines[i] = line;
+}
+
+static int search_node(const size_t depth, const size_t ply, int alpha, const int beta, const int b_follow_pv)
+{
+    ++s_node_count;
+    s_pv_lengths[ply] = 0;
+
+    if (depth == 0) {
+        return search_captures(ply, alpha, beta);
+    }
+
+    if (ply >= MAX_PLY - 1) {
+        return evaluate_board();
+    }
+
+    const color_t TURN = get_turn();
+    const hash_t HASH = get_hash();
+    const int ORIGINAL_ALPHA = alpha;
+
+    cached_analysis_t cached;
+    int b_cached = probe_analysis_cache(HASH, &cached);
+    if (b_cached && ply > 0) {
+        if (cached.legal_move_count == 0) {
+            return is_in_check(TURN) ? -MATE_SCORE + (int)ply : 0;
+        }
+
+        // an exact score inside the window would end up in a line with the cached depth instead of this one
+        int cached_score = get_search_score(cached.score, ply);
+        int b_inside_window = cached_score > alpha && cached_score < beta;
+        if (cached.depth >= depth
+            && ((cached.bound == CACHE_BOUND_EXACT && !(s_b_searching_lines && b_inside_window))
+                || (cached.bound == CACHE_BOUND_LOWER && cached_score >= beta)
+                || (cached.bound == CACHE_BOUND_UPPER && cached_score <= alpha))) {
+            if (cached.bound == CACHE_BOUND_EXACT && cached.best_move != NO_MOVE) {
+                s_pv_table[ply][0] = cached.best_move;
+                s_pv_lengths[ply] = 1;
+            }
+            return cached_score;
+        }
+    }
+
+    // the previous iteration's line is searched first while we are still on it, then the cached best move
+    const int b_on_pv = b_follow_pv && ply < s_prev_pv_length;
+    const move_t* hash_move_or_null = NULL;
+    if (b_on_pv) {
+        hash_move_or_null = &s_prev_pv[ply];
+    }
+    else if (b_cached && cached.best_move != NO_MOVE) {
+        hash_move_or_null = &cached.best_move;
+    }
+
+    move_picker_t picker;
+    init_move_picker(&picker, get_board(), get_piece_list(), TURN, hash_move_or_null, s_killers[ply], s_history[get_color_index(TURN)]);
+
+    int best_score = -INFINITE_SCORE;
+    move_t best_move = NO_MOVE;
+    size_t legal_move_count = 0;
+    int b_cutoff = FALSE;
+    move_t move;
+    undo_t undo;
+
+    while (pick_next_move(&picker, &move)) {
+        int b_quiet = !is_capture_move(move);
+
+        make_move(move, &undo);
+        if (is_in_check(TURN)) {
+            unmake_move(&undo);
+            continue;
+        }
+        ++legal_move_count;
+
+        int b_child_follow_pv = b_on_pv && move == s_prev_pv[ply];
+        int score = -search_node(depth - 1, ply + 1, -beta, -alpha, b_child_follow_pv);
+
+        unmake_move(&undo);
+
+        if (score > best_score) {
+            best_score = score;
+        }
+
+        if (score > alpha) {
+            alpha = score;
+            best_move = move;
+
+            s_pv_table[ply][0] = move;
+            memcpy(&s_pv_table[ply][1], s_pv_table[ply + 1], s_pv_lengths[ply + 1] * sizeof(move_t));
+            s_pv_lengths[ply] = s_pv_lengths[ply + 1] + 1;
+        }
+
+        if (alpha >= beta) {
+            if (b_quiet) {
+                update_quiet_heuristics(move, depth, ply);
+            }
+            b_cutoff = TRUE;
+            break;
+        }
+    }
+
+    cached_analysis_t analysis;
+    if (legal_move_count == 0) {
+        best_score = is_in_check(TURN) ? -MATE_SCORE + (int)ply : 0;
+        analysis.bound = CACHE_BOUND_EXACT;
+    }
+    else if (b_cutoff) {
+        analysis.bound = CACHE_BOUND_LOWER;
+    }
+    else {
+        analysis.bound = (best_score > ORIGINAL_ALPHA) ? CACHE_BOUND_EXACT : CACHE_BOUND_UPPER;
+    }
+
+    analysis.best_move = best_move;
+    analysis.score = get_cache_score(best_score, ply);
+    analysis.depth = depth;
+    analysis.legal_move_count = b_cutoff ? UNKNOWN_LEGAL_MOVE_COUNT : legal_move_count;
+    store_analysis_cache(HASH, &analysis);
+
+    return best_score;
+}
+
+static int search_captures(const size_t ply, int alpha, const int beta)
+{
+    ++s_node_count;
+    s_pv_lengths[ply] = 0;
+
+    int stand_pat = evaluate_board();
+    if (stand_pat >= beta || ply >= MAX_PLY - 1) {
+        return stand_pat;
+    }
+
+    if (stand_pat > alpha) {
+        alpha = stand_pat;
+    }
+
+    const color_t TURN = get_turn();
+
+    move_picker_t picker;
+    init_capture_picker(&picker, get_board(), get_piece_list(), TURN);
+
+    int best_score = stand_pat;
+    move_t move;
+    undo_t undo;
+
+    while (pick_next_move(&picker, &move)) {
+        make_move(move, &undo);
+        if (is_in_check(TURN)) {
+            unmake_move(&undo);
+            continue;
+        }
+
+        int score = -search_captures(ply + 1, -beta, -alpha);
+
+        unmake_move(&undo);
+
+        if (score > best_score) {
+            best_score = score;
+        }
+
+        if (score > alpha) {
+            alpha = score;
+        }
+
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    return best_score;
+}
+
+static void update_quiet_heuristics(const move_t move, const size_t depth, const size_t ply)
+{
+    if (s_killers[ply][0] != move) {
+        s_killers[ply][1] = s_killers[ply][0];
+        s_killers[ply][0] = move;
+    }
+
+    int* history = &s_history[get_color_index(get_turn())][get_move_src(move)][get_move_dest(move)];
+    *history += (int)(depth * depth);
+    if (*history > MAX_HISTORY_SCORE) {
+        age_history();
+    }
+}
+
+// older searches still say something about the position, but less than the current one
+static void age_history(void)
+{
+    for (size_t i = 0; i < COLOR_COUNT; ++i) {
+        for (size_t from = 0; from < SQUARE_COUNT; ++from) {
+            for (size_t to = 0; to < SQUARE_COUNT; ++to) {
+                s_history[i][from][to] /= 2;
+            }
+        }
+    }
+}
+
+static int is_legal_move(const move_t move)
+{
+    square_t src = get_move_src(move);
+    if (get_color(get_board()[src]) != get_turn()) {
+        return FALSE;
+    }
+
+    move_list_t movable_list;
+    get_movable_list(get_board(), get_piece_list(), get_attack_map(), src, &movable_list);
+
+    return contains_move(&movable_list, move);
+}
+
+// mate scores are stored as distance from the cached position, not from the root
+static int get_cache_score(const int score, const size_t ply)
+{
+    if (score > MATE_SCORE - MAX_PLY) {
+        return score + (int)ply;
+    }
+    if (score < -MATE_SCORE + MAX_PLY) {
+        return score - (int)ply;
+    }
+
+    return score;
+}
+
+static int get_search_score(const int cache_score, const size_t ply)
+{
+    if (cache_score > MATE_SCORE - MAX_PLY) {
+        return cache_score - (int)ply;
+    }
+    if (cache_score < -MATE_SCORE + MAX_PLY) {
+        return cache_score + (int)ply;
+    }
+
+    return cache_score;
+}
\ No newline at end of file
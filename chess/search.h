@@ -0,0 +1,38 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "common_defines.h"
+#include "evaluation.h"
+#include "piece.h"
+
+#define INFINITE_SCORE (32000)
+
+typedef struct search_result {
+	move_t best_move;
+	int b_has_best_move;
+	int score;
+	size_t depth;
+	unsigned long long node_count;
+} search_result_t;
+
+// a root move with its principal variation, the score is from the side to move's point of view
+typedef struct search_line {
+	move_t moves[MAX_PLY];
+	size_t length;
+	int score;
+} search_line_t;
+
+// lines are sorted best first
+typedef struct search_report {
+	size_t depth;
+	const search_line_t* lines;
+	size_t line_count;
+	unsigned long long node_count;
+} search_report_t;
+
+typedef void (*search_report_func_t)(const search_report_t* report);
+
+void search(const size_t max_depth, search_result_t* out_result);
+void search_lines(const size_t max_depth, const size_t line_count, search_report_func_t report);
+
+#endif // SEARCH_H
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include <assert.h>
+#include <stddef.h>
+
+#include "zobrist.h"
+
+// keys must come out the same in every process, hashes are stored on disk
+#define ZOBRIST_SEED (0x9e3779b97f4a7c15ULL)
+
+static hash_t s_piece_keys[COLOR_COUNT * SHAPE_COUNT][SQUARE_COUNT];
+static hash_t s_turn_key;
+static int s_b_initialized = FALSE;
+
+static hash_t next_random(hash_t* state);
+
+void init_zobrist(void)
+{
+    if (s_b_initialized) {
+        return;
+    }
+
+    hash_t state = ZOBRIST_SEED;
+    for (size_t i = 0; i < COLOR_COUNT * SHAPE_COUNT; ++i) {
+        for (size_t square = 0; square < SQUARE_COUNT; ++square) {
+            s_piece_keys[i][square] = next_random(&state);
+        }
+    }
+    s_turn_key = next_random(&state);
+
+    s_b_initialized = TRUE;
+}
+
+// MOVE_FLAG is left out: a pawn still on its starting rank has never moved,
+// and nothing else depends on it
+hash_t get_piece_key(const piece_t piece, const square_t square)
+{
+    assert(s_b_initialized);
+    assert(square < SQUARE_COUNT);
+
+    size_t index = get_color_index(get_color(piece)) * SHAPE_COUNT + get_shape_index(get_shape(piece));
+
+    return s_piece_keys[index][square];
+}
+
+hash_t get_turn_key(void)
+{
+    assert(s_b_initialized);
+
+    return s_turn_key;
+}
+
+// splitmix64
+static hash_t next_random(hash_t* state)
+{
+    hash_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+    return z ^ (z >> 31);
+}
\ No newline at end of file
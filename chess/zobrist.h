@@ -0,0 +1,15 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "common_defines.h"
+#include "move.h"
+#include "piece.h"
+
+typedef unsigned long long hash_t;
+
+void init_zobrist(void);
+
+hash_t get_piece_key(const piece_t piece, const square_t square);
+hash_t get_turn_key(void);
+
+#endif // ZOBRIST_H
\ No newline at end of file